@@ -1,5 +1,13 @@
 #include <AngouriMath.h>
+#include <ComputeServer.h>
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include "CPlusPlusWrapperUnitTests.kernels.h"
 
 TEST(RunTests, ParsingTest1) {
     auto src = "x / 2 + 3";
@@ -174,3 +182,672 @@ TEST(RunTests, ToComplex) {
     EXPECT_EQ(6.0, com.real());
     EXPECT_EQ(1.0, com.imag());
 }
+
+TEST(RunTests, SubstituteMany1) {
+    auto expr = AngouriMath::Entity("x + 2y");
+    double values[] = { 1, 2, 3, 4, 5, 6 };
+    auto res = expr.SubstituteManyReal({ "x", "y" }, values, 3);
+    ASSERT_EQ(3, res.values.size());
+    EXPECT_EQ(5.0, res.values[0]);
+    EXPECT_EQ(11.0, res.values[1]);
+    EXPECT_EQ(17.0, res.values[2]);
+    EXPECT_EQ(0, res.errors[0] + res.errors[1] + res.errors[2]);
+}
+
+TEST(RunTests, SubstituteManyPole) {
+    auto expr = AngouriMath::Entity("1 / x");
+    double values[] = { 2, 0 };
+    auto res = expr.SubstituteMany({ "x" }, values, 2);
+    EXPECT_EQ(0.5, res.values[0].real());
+    EXPECT_EQ(0, res.errors[0]);
+    EXPECT_NE(0, res.errors[1]);
+}
+
+TEST(RunTests, SubstituteGrid1) {
+    auto expr = AngouriMath::Entity("x - y");
+    auto res = expr.SubstituteGridReal({ "x", "y" }, { { 1, 2 }, { 10, 20, 30 } });
+    ASSERT_EQ(6, res.values.size());
+    EXPECT_EQ(-9.0, res.values[0]);
+    EXPECT_EQ(-19.0, res.values[1]);
+    EXPECT_EQ(-29.0, res.values[2]);
+    EXPECT_EQ(-8.0, res.values[3]);
+}
+
+TEST(RunTests, Compile1) {
+    auto compiled = AngouriMath::Entity("x2 + sin(y)").Compile({ "x", "y" });
+    double args[] = { 3, 0 };
+    double out;
+    compiled.Evaluate(args, &out);
+    EXPECT_EQ(9.0, out);
+}
+
+TEST(RunTests, CompileFused1) {
+    std::vector<AngouriMath::Entity> outputs = { "e^(-r t) * a", "e^(-r t) + sqrt(s2 t)" };
+    auto compiled = AngouriMath::CompileFused(outputs, { "r", "t", "a", "s" });
+    EXPECT_EQ(2, compiled.OutputCount());
+    double args[] = { 0, 1, 5, 3 };
+    double out[2];
+    compiled.Evaluate(args, out);
+    EXPECT_DOUBLE_EQ(5.0, out[0]);
+    EXPECT_DOUBLE_EQ(4.0, out[1]);
+}
+
+TEST(RunTests, EmitCpp1) {
+    auto code = AngouriMath::Entity("x2 + y").EmitCpp("f", { "x", "y" });
+    EXPECT_NE(std::string::npos, code.find("constexpr double f(double x, double y)"));
+    EXPECT_NE(std::string::npos, code.find("inline std::complex<double> f(std::complex<double> x, std::complex<double> y)"));
+}
+
+TEST(RunTests, GeneratedKernels1) {
+    EXPECT_EQ(10.0, KernelSquarePlusOne(3.0));
+    EXPECT_EQ(1.0, KernelSinCos(0.0, 0.0));
+    EXPECT_EQ(std::complex<double>(10.0), KernelSquarePlusOne(std::complex<double>(3.0)));
+}
+
+TEST(RunTests, Jit1) {
+    auto compiled = AngouriMath::Entity("sin(x) * y + x3").Compile({ "x", "y" });
+    double args[] = { 0.5, 2, 1, -3 };
+    double interpreted[2];
+    compiled.EvaluateMany(args, 2, interpreted);
+    // falls back to the interpreter when there is no compiler, so the results are the same either way
+    EXPECT_EQ(compiled.Jit(), compiled.IsJitted());
+    double jitted[2];
+    compiled.EvaluateMany(args, 2, jitted);
+    EXPECT_DOUBLE_EQ(interpreted[0], jitted[0]);
+    EXPECT_DOUBLE_EQ(interpreted[1], jitted[1]);
+}
+
+TEST(RunTests, StructuralEquality1) {
+    AngouriMath::Entity a = "x + sin(y)";
+    AngouriMath::Entity b = "x + sin(y)";
+    AngouriMath::Entity c = "x + sin(z)";
+    EXPECT_EQ(a.StructuralHash(), b.StructuralHash());
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != c);
+}
+
+TEST(RunTests, StructuralHashSet1) {
+    std::unordered_set<AngouriMath::Entity> set = { "x + 1", "x + 1", "x + 2" };
+    EXPECT_EQ(2, set.size());
+}
+
+TEST(RunTests, Initialize1) {
+    AngouriMath::WarmupOptions options;
+    options.simplifier = true;
+    auto timings = AngouriMath::Initialize(options).get();
+    EXPECT_GT(timings.simplifier.count(), 0);
+    EXPECT_EQ(timings.Total(), timings.runtime + timings.settings + timings.parser + timings.simplifier);
+}
+
+TEST(RunTests, InitializeBackground1) {
+    AngouriMath::WarmupOptions options;
+    options.background = true;
+    auto timings = AngouriMath::Initialize(options);
+    AngouriMath::Entity expr = "x + 1";
+    EXPECT_EQ("x + 1", expr.ToString());
+    EXPECT_EQ(0, timings.get().simplifier.count());
+}
+
+TEST(RunTests, SolveEquationNumeric1) {
+    AngouriMath::Entity expr = "x2 - 4";
+    auto roots = expr.SolveEquationNumeric("x");
+    ASSERT_EQ(2, roots.values.size());
+    EXPECT_EQ((std::vector<size_t>{ 0, 2 }), roots.offsets);
+    double sum = 0;
+    for (size_t i = 0; i < roots.values.size(); i++)
+    {
+        EXPECT_EQ(AngouriMath::RootKind::Exact, roots.kinds[i]);
+        EXPECT_NEAR(4.0, std::norm(roots.values[i]), 1e-9);
+        sum += roots.values[i].real();
+    }
+    EXPECT_NEAR(0.0, sum, 1e-9);
+}
+
+TEST(RunTests, SolveEquationsNumeric1) {
+    auto roots = AngouriMath::SolveEquationsNumeric({ "x - 1", "x - a", "x2 + 1" }, "x");
+    EXPECT_EQ((std::vector<size_t>{ 0, 1, 2, 4 }), roots.offsets);
+    EXPECT_EQ(std::complex<double>(1.0, 0.0), roots.values[0]);
+    EXPECT_EQ(AngouriMath::RootKind::Symbolic, roots.kinds[1]);
+    EXPECT_TRUE(std::isnan(roots.values[1].real()));
+    EXPECT_NEAR(1.0, std::abs(roots.values[2].imag()), 1e-9);
+}
+
+TEST(RunTests, EquationSystemSolve1) {
+    AngouriMath::EquationSystem system({ "x + y - 3", "x - y - 1" });
+    auto solutions = system.Solve({ "x", "y" });
+    ASSERT_EQ(1, solutions.size());
+    EXPECT_EQ(2, solutions[0][0].AsInteger());
+    EXPECT_EQ(1, solutions[0][1].AsInteger());
+}
+
+TEST(RunTests, EquationSystemSolveMany1) {
+    AngouriMath::EquationSystem system({ "x + y - a", "x - y - b" });
+    double coefficients[] = {
+        3, 1,
+        10, 4,
+    };
+    auto res = system.SolveMany({ "x", "y" }, { "a", "b" }, coefficients, 2);
+    ASSERT_EQ(1, res.solutionCount);
+    ASSERT_EQ(2, res.varCount);
+    EXPECT_NEAR(2.0, res.values[0].real(), 1e-9);
+    EXPECT_NEAR(1.0, res.values[1].real(), 1e-9);
+    EXPECT_NEAR(7.0, res.values[2].real(), 1e-9);
+    EXPECT_NEAR(3.0, res.values[3].real(), 1e-9);
+    EXPECT_EQ((std::vector<std::uint8_t>{ 0, 0 }), res.errors);
+}
+
+TEST(RunTests, MatrixBuffer1) {
+    double values[] = { 1, 2, 3, 4, 5, 6 };
+    auto m = AngouriMath::Matrix::FromBuffer(values, 2, 3);
+    EXPECT_EQ(2, m.RowCount());
+    EXPECT_EQ(3, m.ColumnCount());
+    double out[6];
+    m.ToBuffer(out);
+    EXPECT_EQ((std::vector<double>(values, values + 6)), (std::vector<double>(out, out + 6)));
+}
+
+TEST(RunTests, MatrixBufferComplex1) {
+    std::complex<double> values[] = { { 1, 2 }, { 3, -4 } };
+    auto m = AngouriMath::Matrix::FromBuffer(values, 1, 2);
+    std::complex<double> out[2];
+    m.ToBuffer(out);
+    EXPECT_EQ(values[0], out[0]);
+    EXPECT_EQ(values[1], out[1]);
+    double real[2];
+    EXPECT_THROW(m.ToBuffer(real), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, MatrixCompile1) {
+    AngouriMath::Matrix m(AngouriMath::Entity("[[x, x y], [sin(y), 2]]"));
+    auto compiled = m.Compile({ "x", "y" });
+    ASSERT_EQ(4, compiled.OutputCount());
+    double args[] = { 3, 0 };
+    double out[4];
+    compiled.Evaluate(args, out);
+    EXPECT_EQ(3.0, out[0]);
+    EXPECT_EQ(0.0, out[1]);
+    EXPECT_EQ(0.0, out[2]);
+    EXPECT_EQ(2.0, out[3]);
+}
+
+TEST(RunTests, AsPolynomial1) {
+    AngouriMath::Entity expr = "(x - 1)(x - 2) + x / 2";
+    auto terms = expr.PolynomialTerms("x");
+    ASSERT_EQ(3, terms.size());
+    EXPECT_EQ(1, terms[1].power);
+    EXPECT_TRUE(terms[1].isRational);
+    EXPECT_EQ(-5, terms[1].numerator);
+    EXPECT_EQ(2, terms[1].denominator);
+    auto p = expr.AsPolynomial("x");
+    EXPECT_EQ(2, p.Degree());
+    EXPECT_EQ(3.5, p(3.0));
+    EXPECT_EQ(-0.5, p.Derivative()(1.0));
+    EXPECT_THROW(AngouriMath::Entity("sin(x)").AsPolynomial("x"), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, PolynomialEvaluate1) {
+    AngouriMath::Polynomial p(std::vector<double>{ 1, -3, 0, 2 });
+    std::vector<double> xs(19), out(19);
+    for (size_t i = 0; i < xs.size(); i++)
+        xs[i] = i * 0.25 - 2;
+    p.Evaluate(xs.data(), xs.size(), out.data());
+    for (size_t i = 0; i < xs.size(); i++)
+        EXPECT_DOUBLE_EQ(1 - 3 * xs[i] + 2 * xs[i] * xs[i] * xs[i], out[i]);
+}
+
+TEST(RunTests, PolynomialRoots1) {
+    // (x - 1)(x - 2)(x - 3) and x^2 + 1
+    std::vector<AngouriMath::Polynomial> polynomials = {
+        AngouriMath::Polynomial(std::vector<double>{ -6, 11, -6, 1 }),
+        AngouriMath::Polynomial(std::vector<double>{ 1, 0, 1 }),
+    };
+    auto roots = AngouriMath::PolynomialRoots(polynomials);
+    ASSERT_EQ(3, roots[0].size());
+    ASSERT_EQ(2, roots[1].size());
+    double sum = 0;
+    for (auto root : roots[0])
+        sum += root.real();
+    EXPECT_NEAR(6.0, sum, 1e-9);
+    for (auto root : roots[1])
+        EXPECT_NEAR(1.0, std::abs(root.imag()), 1e-9);
+}
+
+TEST(RunTests, CompileTaylor1) {
+    AngouriMath::Entity expr = "sin(x)";
+    auto surrogate = expr.CompileTaylor("x", 0.0, 7, 0.5);
+    EXPECT_EQ(7, surrogate.Terms().Degree());
+    EXPECT_LT(surrogate.ErrorBound(), 1e-6);
+    EXPECT_NEAR(std::sin(0.3), surrogate(0.3), surrogate.ErrorBound());
+    EXPECT_TRUE(surrogate.TryEvaluate(-0.5).has_value());
+    EXPECT_FALSE(surrogate.TryEvaluate(0.6).has_value());
+
+    double xs[] = { -0.4, 0.1, 0.9 };
+    double out[3];
+    std::uint8_t outside[3];
+    EXPECT_EQ(1, surrogate.Evaluate(xs, 3, out, outside));
+    EXPECT_EQ(0, outside[0]);
+    EXPECT_EQ(1, outside[2]);
+    EXPECT_NEAR(std::sin(0.1), out[1], surrogate.ErrorBound());
+}
+
+TEST(RunTests, CompileTaylorPole1) {
+    AngouriMath::Entity expr = "1 / (x - 1)";
+    EXPECT_TRUE(std::isinf(expr.CompileTaylor("x", 0.0, 3, 2.0).ErrorBound()));
+}
+
+TEST(RunTests, IntegrateNumeric1) {
+    AngouriMath::Entity expr = "sin(x)";
+    auto res = expr.IntegrateNumeric("x", 0.0, 3.14159265358979323846);
+    EXPECT_TRUE(res.converged);
+    EXPECT_NEAR(2.0, res.value, 1e-10);
+    EXPECT_LE(res.errorEstimate, 1e-10);
+}
+
+TEST(RunTests, IntegrateNumericMany1) {
+    AngouriMath::Entity expr = "sqrt(x)";
+    auto res = expr.IntegrateNumeric("x", { { 0.0, 1.0 }, { 0.0, 4.0 } }, 1e-9);
+    ASSERT_EQ(2, res.size());
+    EXPECT_NEAR(2.0 / 3, res[0].value, 1e-9);
+    EXPECT_NEAR(16.0 / 3, res[1].value, 1e-9);
+}
+
+TEST(RunTests, IntegrateNumericPole1) {
+    AngouriMath::Entity expr = "1 / x";
+    EXPECT_FALSE(expr.IntegrateNumeric("x", -1.0, 1.0).converged);
+}
+
+TEST(RunTests, EvaluateGrid1) {
+    AngouriMath::Entity expr = "1 / (x y)";
+    const size_t nx = 21, ny = 11;
+    std::vector<float> out(nx * ny);
+    std::vector<std::uint8_t> invalid((nx * ny + 7) / 8);
+    AngouriMath::GridOptions options;
+    options.invalid = invalid.data();
+    options.tileSize = 16;
+    EXPECT_TRUE(expr.EvaluateGrid("x", "y", { -1, 1 }, { -2, 3 }, nx, ny, out.data(), options));
+    // x = -0.9 at column 1, y = 0.5 at row 5
+    EXPECT_FLOAT_EQ(1 / (-0.9f * 0.5f), out[5 * nx + 1]);
+    size_t poles = 0;
+    for (size_t i = 0; i < nx * ny; i++)
+        poles += (invalid[i / 8] >> (i % 8)) & 1;
+    // x = 0 at column 10, y = 0 at row 4
+    EXPECT_EQ(nx + ny - 1, poles);
+}
+
+TEST(RunTests, EvaluateGrid3DCancel1) {
+    AngouriMath::Entity expr = "x + y + z";
+    std::vector<float> out(8 * 8 * 8);
+    EXPECT_TRUE(expr.EvaluateGrid("x", "y", "z", { 0, 7 }, { 0, 70 }, { 0, 700 }, 8, 8, 8, out.data()));
+    EXPECT_EQ(321.0f, out[(3 * 8 + 2) * 8 + 1]);
+    std::atomic<bool> cancel{ true };
+    AngouriMath::GridOptions options;
+    options.cancel = &cancel;
+    EXPECT_FALSE(expr.EvaluateGrid("x", "y", "z", { 0, 7 }, { 0, 70 }, { 0, 700 }, 8, 8, 8, out.data(), options));
+}
+
+TEST(RunTests, SimplificationCache1) {
+    AngouriMath::SimplificationCacheOptions options;
+    options.path = (std::filesystem::temp_directory_path() / "angourimath-tests-simplify.cache").string();
+    std::filesystem::remove(options.path);
+    ASSERT_TRUE(AngouriMath::EnableSimplificationCache(options));
+    AngouriMath::Entity expr = "sin(x)^2 + cos(x)^2 + a + a";
+    auto first = expr.Simplify();
+    auto second = AngouriMath::Entity("sin(x)^2 + cos(x)^2 + a + a").Simplify();
+    auto stats = AngouriMath::GetSimplificationCacheStats();
+    AngouriMath::DisableSimplificationCache();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(1, stats.hits);
+}
+
+TEST(RunTests, SimplificationCacheInvalid1) {
+    AngouriMath::SimplificationCacheOptions options;
+    options.path = (std::filesystem::temp_directory_path() / "angourimath-tests-invalid.cache").string();
+    options.maxBytes = 1u << 16;
+    {
+        std::ofstream garbage(options.path, std::ios::binary | std::ios::trunc);
+        garbage << std::string(1u << 20, 'x');
+    }
+    ASSERT_TRUE(AngouriMath::EnableSimplificationCache(options));
+    AngouriMath::DisableSimplificationCache();
+    auto size = std::filesystem::file_size(options.path);
+    EXPECT_LE(size, options.maxBytes);
+    // the rewritten file is valid now and is reused as is
+    ASSERT_TRUE(AngouriMath::EnableSimplificationCache(options));
+    AngouriMath::DisableSimplificationCache();
+    EXPECT_EQ(size, std::filesystem::file_size(options.path));
+    std::filesystem::remove(options.path);
+}
+
+TEST(RunTests, SimplifyBudget1) {
+    AngouriMath::Entity expr = "sin(x)^2 + cos(x)^2";
+    AngouriMath::SimplifyReport report;
+    auto simplified = expr.Simplify(AngouriMath::SimplifyOptions{}, &report);
+    EXPECT_EQ("1", simplified.ToString());
+    EXPECT_FALSE(report.budgetExceeded);
+    EXPECT_GT(report.alternativesExplored, 0u);
+}
+
+TEST(RunTests, SimplifyBudget2) {
+    AngouriMath::Entity expr = "sin(x)^2 + cos(x)^2 + a * b + a * c";
+    AngouriMath::SimplifyOptions options;
+    options.maxNodes = 3;
+    AngouriMath::SimplifyReport report;
+    auto simplified = expr.Simplify(options, &report);
+    EXPECT_TRUE(report.budgetExceeded);
+    EXPECT_EQ(0u, report.alternativesExplored);
+    EXPECT_EQ(expr.InnerSimplified().ToString(), simplified.ToString());
+}
+
+TEST(RunTests, Tracing1) {
+    AngouriMath::EnableTracing();
+    AngouriMath::ClearTrace();
+    AngouriMath::Entity expr = "x + x";
+    (void)expr.Simplify();
+    AngouriMath::DisableTracing();
+    const auto trace = AngouriMath::ChromeTrace();
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Entity::Simplify\",\"cat\":\"native\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"EntitySimplify\",\"cat\":\"managed\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"ObjStorage.Get\""));
+}
+
+TEST(RunTests, Tracing2) {
+    AngouriMath::ClearTrace();
+    AngouriMath::Entity expr = "x + x";
+    (void)expr.Simplify();
+    EXPECT_EQ(std::string::npos, AngouriMath::ChromeTrace().find("Entity::Simplify"));
+}
+
+TEST(RunTests, NodesCursor1) {
+    AngouriMath::Entity expr = "a + b * c";
+    std::vector<std::string> nodes;
+    for (const auto& node : expr.NodesCursor(2))
+        nodes.push_back(node.ToString());
+    ASSERT_EQ(expr.Nodes().size(), nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+        EXPECT_EQ(expr.Nodes()[i].ToString(), nodes[i]);
+}
+
+TEST(RunTests, NodesCursorEarlyExit1) {
+    AngouriMath::Entity expr = "sin(a + b) * cos(c) + d ^ e";
+    auto cursor = expr.NodesCursor();
+    auto first = cursor.Next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(expr.ToString(), first->ToString());
+    cursor.Close();
+    EXPECT_FALSE(cursor.Next().has_value());
+
+    auto alternates = AngouriMath::Entity("x + sin(x / 2)").AlternateCursor();
+    ASSERT_NE(alternates.end(), alternates.begin());
+    EXPECT_EQ(AngouriMath::Entity("x + sin(x / 2)").ToString(), alternates.begin()->ToString());
+}
+
+TEST(RunTests, CompileBoolean1) {
+    AngouriMath::Entity a = "a", b = "b", c = "c";
+    auto f = AngouriMath::Entity("(a and b) or not c").CompileBoolean({ a, b, c });
+    // bit i is the assignment with a = bit 0, b = bit 1, c = bit 2 of i
+    auto table = f.TruthTable();
+    ASSERT_EQ(1u, table.size());
+    EXPECT_EQ(0b10001111u, table[0]);
+    EXPECT_EQ(5u, f.CountSatisfying());
+    EXPECT_EQ((std::vector<std::uint64_t>{ 0, 1, 2, 3, 7 }), f.SatisfyingAssignments());
+    EXPECT_TRUE(f({ true, true, true }));
+    EXPECT_FALSE(f({ true, false, true }));
+}
+
+TEST(RunTests, CompileBoolean2) {
+    std::vector<AngouriMath::Entity> vars;
+    std::string formula = "false";
+    for (int i = 0; i < 20; i++)
+    {
+        vars.emplace_back("x_" + std::to_string(i));
+        formula = "(" + formula + ") xor x_" + std::to_string(i);
+    }
+    auto f = AngouriMath::Entity(formula).CompileBoolean(vars);
+    EXPECT_EQ(1u << 19, f.CountSatisfying());
+    EXPECT_EQ((std::vector<std::uint64_t>{ 1, 2, 4 }), f.SatisfyingAssignments(3));
+    EXPECT_THROW(AngouriMath::Entity("a + 1").CompileBoolean({ "a" }), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, ComputeServerInProcess1) {
+    AngouriMath::ComputeServerOptions options;
+    options.inProcess = true;
+    AngouriMath::ComputeServerPool pool(options);
+    EXPECT_EQ(AngouriMath::Entity("x + x").Simplify().ToString(), pool.Simplify("x + x"));
+    EXPECT_EQ(AngouriMath::Entity("x2").Differentiate("x").ToString(), pool.Differentiate("x2", "x"));
+    EXPECT_THROW(pool.Simplify("x +"), AngouriMath::AngouriMathException);
+    EXPECT_EQ(0u, pool.Stats().spawned);
+}
+
+// workers are separate processes everywhere but on Windows
+#if !defined(_WIN32)
+TEST(RunTests, ComputeServer1) {
+    AngouriMath::ComputeServerOptions options;
+    options.workers = 1;
+    options.maxRequestsPerWorker = 2;
+    AngouriMath::ComputeServerPool pool(options);
+    EXPECT_EQ(AngouriMath::Entity("sin(x)2 + cos(x)2").Simplify().ToString(), pool.Simplify("sin(x)2 + cos(x)2"));
+    const std::vector<double> values{ 1, 2, 3 };
+    auto batch = pool.SubstituteMany("x2 + 1", { "x" }, values.data(), values.size());
+    ASSERT_EQ(3u, batch.values.size());
+    EXPECT_DOUBLE_EQ(10.0, batch.values[2].real());
+    EXPECT_EQ(AngouriMath::Entity("x / 2").Latexise(), pool.Latexise("x / 2"));
+    EXPECT_EQ(2u, pool.Stats().spawned);
+    EXPECT_EQ(1u, pool.Stats().recycled);
+}
+
+TEST(RunTests, ComputeServerDeadline1) {
+    AngouriMath::ComputeServerPool pool;
+    // no worker starts its runtime that fast
+    try
+    {
+        pool.Simplify("x + x", std::chrono::milliseconds(1));
+        FAIL();
+    }
+    catch (const AngouriMath::AngouriMathException& e)
+    {
+        EXPECT_EQ("AngouriMath.Server.DeadlineExceeded", e.Name());
+    }
+    EXPECT_EQ(AngouriMath::Entity("x + x").Simplify().ToString(), pool.Simplify("x + x"));
+}
+#endif
+
+TEST(RunTests, GarbageCollector1) {
+    const auto before = AngouriMath::GetGarbageCollectorInfo();
+    // the runtime defaults unless the environment overrides them
+    const auto concurrent = std::getenv("DOTNET_gcConcurrent");
+    const auto conserveMemory = std::getenv("DOTNET_GCConserveMemory");
+    EXPECT_EQ(concurrent == nullptr || std::strtol(concurrent, nullptr, 16) != 0, before.concurrent);
+    EXPECT_EQ(conserveMemory == nullptr ? 0 : (int)std::strtol(conserveMemory, nullptr, 16), before.conserveMemory);
+    {
+        AngouriMath::GcBatchScope batch;
+        EXPECT_EQ(AngouriMath::GcLatencyMode::Batch, AngouriMath::GetGarbageCollectorInfo().latencyMode);
+        for (int i = 0; i < 100; i++)
+            (void)AngouriMath::Entity("x + " + std::to_string(i)).Simplify();
+    }
+    const auto after = AngouriMath::GetGarbageCollectorInfo();
+    EXPECT_EQ(before.latencyMode, after.latencyMode);
+    EXPECT_LT(before.collections[2], after.collections[2]);
+    EXPECT_GT(after.totalAllocated, before.totalAllocated);
+    EXPECT_GE(after.totalPause, before.totalPause);
+}
+
+TEST(RunTests, GarbageCollectorHeapLimit1) {
+    AngouriMath::SetHeapHardLimit(size_t(512) << 20);
+    EXPECT_EQ(size_t(512) << 20, AngouriMath::GetGarbageCollectorInfo().heapHardLimit);
+    // heapHardLimit reports the available memory when there is no limit, so it cannot be restored from it
+    AngouriMath::SetHeapHardLimit(0);
+}
+
+TEST(RunTests, SubstituteReplace1) {
+    AngouriMath::Entity expr = "x * y + x";
+    EXPECT_EQ(AngouriMath::Entity("2 * y + 2"), expr.Substitute("x", "2"));
+    EXPECT_EQ(AngouriMath::Entity("y * x + y"), expr.Substitute({ "x", "y" }, { "y", "x" }));
+    const auto product = expr.DirectChildren()[0];
+    EXPECT_EQ(AngouriMath::Entity("z + x"), expr.Replace(product, "z"));
+    // equal, but not a node of the expression
+    EXPECT_THROW(expr.Replace(AngouriMath::Entity("x * y"), "z"), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, SimplifyIncremental1) {
+    AngouriMath::ClearIncrementalSimplification();
+    AngouriMath::Entity expr = "(a + a) + (b + b) + (c + c) + (d + d)";
+    AngouriMath::IncrementalSimplifyReport report;
+    auto simplified = expr.SimplifyIncremental(2, 2, &report);
+    EXPECT_EQ(7u, report.simplified);
+    EXPECT_EQ(20.0, simplified.Substitute({ "a", "b", "c", "d" }, { "1", "2", "3", "4" }).Evaled().AsReal());
+
+    (void)expr.SimplifyIncremental(2, 2, &report);
+    EXPECT_EQ(0u, report.simplified);
+    EXPECT_EQ(1u, report.reused);
+
+    // only the new subtree and the root are simplified again
+    auto edited = expr.Replace(expr.DirectChildren()[1], "e + e");
+    simplified = edited.SimplifyIncremental(2, 2, &report);
+    EXPECT_EQ(2u, report.simplified);
+    EXPECT_EQ(1u, report.reused);
+    EXPECT_EQ(20.0, simplified.Substitute({ "a", "b", "c", "e" }, { "1", "2", "3", "4" }).Evaled().AsReal());
+}
+
+namespace
+{
+    void ExpectSameParse(const std::string& src)
+    {
+        const auto native = AngouriMath::ParseNative(src);
+        ASSERT_TRUE(native.has_value()) << src;
+        const auto managed = AngouriMath::ParseManaged(src);
+        EXPECT_EQ(managed, *native) << src;
+        EXPECT_EQ(managed.ToString(), native->ToString()) << src;
+    }
+
+    // random expression of the subset the native parser handles, with and without
+    // omitted operators, spaces and redundant signs
+    std::string RandomExpression(std::mt19937& rng, int depth)
+    {
+        const char* atoms[] = { "x", "y_1", "alpha", "2", "3.5", "0.25e-3", ".5", "2i", "i", "17" };
+        const char* functions[] = { "sin", "cos", "tan", "cot", "sqrt", "ln", "arcsin", "atanh", "sh", "gamma", "abs", "sgn", "phi", "cbrt" };
+        const char* operators[] = { " + ", "-", " * ", "/", "^" };
+        auto pick = [&](int n) { return (int)(rng() % (unsigned)n); };
+        if (depth == 0)
+            return atoms[pick(10)];
+        switch (pick(8))
+        {
+        case 0: return "(" + RandomExpression(rng, depth - 1) + ")";
+        case 1: return std::string(functions[pick(14)]) + "(" + RandomExpression(rng, depth - 1) + ")";
+        case 2: return "log(" + RandomExpression(rng, depth - 1) + (pick(2) ? ", " + RandomExpression(rng, depth - 1) : "") + ")";
+        case 3: return (pick(2) ? "-" : "+") + RandomExpression(rng, depth - 1);
+        case 4: return "(" + RandomExpression(rng, depth - 1) + ")!";
+        // omitted multiplication
+        case 5: return "2" + std::string(pick(2) ? "x" : "(y + 1)");
+        default: return RandomExpression(rng, depth - 1) + operators[pick(5)] + RandomExpression(rng, depth - 1);
+        }
+    }
+}
+
+TEST(RunTests, ParseNative1) {
+    for (const auto* src : {
+        "x / 2 + 3", "-2^2", "-x^2", "2^-3", "--x", "-+-2", "a^b^c", "a^-b^c", "x!^2", "3!",
+        "2x", "x2", "2(x + 1)", "sin(x)cos(x)", "(x)(y)", "sin (x)", "2e", "2e+1", "1.e5i", "2in",
+        "log(x)", "log(2, x)", "sinh(x) + xsin(x)", "  x\t+\r\ny", "i", "ix", "i_2" })
+        ExpectSameParse(src);
+}
+
+TEST(RunTests, ParseNativeDifferential1) {
+    std::mt19937 rng(48);
+    for (int i = 0; i < 500; i++)
+        ExpectSameParse(RandomExpression(rng, 4));
+}
+
+TEST(RunTests, ParseNativeFallback1) {
+    for (const auto* src : {
+        "x = 2", "x in RR", "true", "+oo", "-oo + 1", "(|x|)", "derivative(x, x)", "[1, 2]", "{ 1 }",
+        "x // comment\n", "x -> y", "sin()", "sqrt(x, y)", "x_", "(1, 2)", "\xce\xb1 + 1", "x +" })
+        EXPECT_FALSE(AngouriMath::ParseNative(src).has_value()) << src;
+    // the full parser is used for them
+    AngouriMath::Entity derivative = "derivative(x, x)";
+    EXPECT_EQ(AngouriMath::ParseManaged("derivative(x, x)"), derivative);
+    AngouriMath::Entity interval = "(1; 2)";
+    EXPECT_EQ(AngouriMath::ParseManaged("(1; 2)"), interval);
+    EXPECT_THROW(AngouriMath::Entity("x +"), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, SettingsScope1) {
+    const auto defaults = AngouriMath::CurrentSettings();
+    EXPECT_TRUE(defaults.allowNewton);
+    {
+        AngouriMath::SettingsOverrides overrides;
+        overrides.allowNewton = false;
+        overrides.floatToRationalIterCount = 3;
+        AngouriMath::SettingsScope scope(overrides);
+        EXPECT_FALSE(AngouriMath::CurrentSettings().allowNewton);
+        {
+            AngouriMath::SettingsOverrides inner;
+            inner.precisionErrorCommon = 1e-3;
+            inner.explicitParsingOnly = true;
+            AngouriMath::SettingsScope innerScope(inner);
+            const auto settings = AngouriMath::CurrentSettings();
+            EXPECT_EQ(1e-3, settings.precisionErrorCommon);
+            EXPECT_EQ(3, settings.floatToRationalIterCount);
+            EXPECT_THROW(AngouriMath::Entity("2x"), AngouriMath::AngouriMathException);
+        }
+        EXPECT_EQ(defaults.precisionErrorCommon, AngouriMath::CurrentSettings().precisionErrorCommon);
+        // other threads keep their own settings
+        std::thread([] { EXPECT_TRUE(AngouriMath::CurrentSettings().allowNewton); }).join();
+    }
+    const auto restored = AngouriMath::CurrentSettings();
+    EXPECT_TRUE(restored.allowNewton);
+    EXPECT_EQ(defaults.floatToRationalIterCount, restored.floatToRationalIterCount);
+    EXPECT_EQ(AngouriMath::Entity("2 * x"), AngouriMath::Entity("2x"));
+}
+
+TEST(RunTests, SettingsScopeInvalid1) {
+    AngouriMath::SettingsOverrides overrides;
+    overrides.allowNewton = false;
+    overrides.precisionErrorCommon = -1.0;
+    EXPECT_THROW(AngouriMath::SettingsScope scope(overrides), AngouriMath::AngouriMathException);
+    // nothing was applied
+    EXPECT_TRUE(AngouriMath::CurrentSettings().allowNewton);
+}
+
+TEST(RunTests, CompileRational1) {
+    AngouriMath::Entity expr = "(x + 1/3) * y / 2 - x^2 + abs(y)";
+    auto f = expr.CompileRational({ "x", "y" });
+    const std::int64_t args[] = { 1, 2, -3, 5, 0, -7 };
+    AngouriMath::Rational out[3];
+    AngouriMath::RationalStatus status[3];
+    f.EvaluateMany(args, 3, out, status);
+    for (size_t row = 0; row < 3; row++)
+    {
+        EXPECT_EQ(AngouriMath::RationalStatus::Exact, status[row]);
+        const auto expected = expr.Substitute({ "x", "y" }, { std::to_string(args[row * 2]), std::to_string(args[row * 2 + 1]) }).Evaled().AsRational();
+        EXPECT_EQ(expected.first, out[row].numerator);
+        EXPECT_EQ(expected.second, out[row].denominator);
+    }
+    // unnormalized arguments
+    const auto value = f({ { 2, -4 }, { 6, 3 } });
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ((AngouriMath::Rational{ 19, 12 }), *value);
+    EXPECT_THROW(AngouriMath::Entity("sin(x)").CompileRational({ "x" }), AngouriMath::AngouriMathException);
+}
+
+TEST(RunTests, CompileRationalFallback1) {
+    auto f = AngouriMath::Entity("x * x / y").CompileRational({ "x", "y" });
+    constexpr std::int64_t big = std::int64_t(1) << 40;
+    const std::int64_t args[] = {
+        // x * x overflows, the result fits
+        big, big,
+        // the result does not fit
+        big, 1,
+        1, 0,
+        2, 3 };
+    AngouriMath::Rational out[4];
+    AngouriMath::RationalStatus status[4];
+    f.EvaluateMany(args, 4, out, status);
+    EXPECT_EQ(AngouriMath::RationalStatus::Managed, status[0]);
+    EXPECT_EQ((AngouriMath::Rational{ big, 1 }), out[0]);
+    EXPECT_EQ(AngouriMath::RationalStatus::Overflow, status[1]);
+    EXPECT_EQ(AngouriMath::RationalStatus::Undefined, status[2]);
+    EXPECT_EQ(AngouriMath::RationalStatus::Exact, status[3]);
+    EXPECT_EQ((AngouriMath::Rational{ 4, 3 }), out[3]);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+// Measures the cold start of the wrapper, so it must run in a fresh process, and the
+// overhead of a single round trip into the exported library. Build it with and without
+// ANGOURIMATH_STATIC to compare the static and the shared library.
+// Usage: CPlusPlusWrapperStartupBenchmark [--lazy] [--max-ms N]
+//   --lazy      skip Initialize, the first request pays the whole startup
+//   --max-ms N  fail if the first request (including Initialize) takes more than N ms
+
+#include <AngouriMath.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std::chrono;
+
+static double Ms(nanoseconds time) { return duration<double, std::milli>(time).count(); }
+
+template<typename Request>
+static nanoseconds Measure(Request&& request)
+{
+    auto start = steady_clock::now();
+    request();
+    return duration_cast<nanoseconds>(steady_clock::now() - start);
+}
+
+int main(int argc, char** argv)
+{
+    bool lazy = false;
+    double maxMs = 0.0;
+    for (int i = 1; i < argc; i++)
+        if (std::strcmp(argv[i], "--lazy") == 0)
+            lazy = true;
+        else if (std::strcmp(argv[i], "--max-ms") == 0 && i + 1 < argc)
+            maxMs = std::atof(argv[++i]);
+
+    auto request = [] { (void)AngouriMath::Entity("a * x^2 + b * x + c").Differentiate("x").ToString(); };
+
+#ifdef ANGOURIMATH_STATIC
+    std::cout << "link        static\n";
+#else
+    std::cout << "link        shared\n";
+#endif
+
+    nanoseconds initialize{};
+    if (!lazy)
+    {
+        AngouriMath::WarmupOptions options;
+        options.simplifier = true;
+        auto timings = AngouriMath::Initialize(options).get();
+        std::cout << "runtime     " << Ms(timings.runtime) << " ms\n";
+        std::cout << "settings    " << Ms(timings.settings) << " ms\n";
+        std::cout << "parser      " << Ms(timings.parser) << " ms\n";
+        std::cout << "simplifier  " << Ms(timings.simplifier) << " ms\n";
+        initialize = timings.Total();
+    }
+
+    auto first = Measure(request);
+    constexpr int steadyRuns = 100;
+    auto steady = Measure([&] { for (int i = 0; i < steadyRuns; i++) request(); }) / steadyRuns;
+
+    std::cout << "first       " << Ms(first) << " ms\n";
+    std::cout << "steady      " << Ms(steady) << " ms\n";
+    std::cout << "cold start  " << Ms(initialize + first) << " ms\n";
+
+    // a boundary round trip which is never cached on the C++ side (unlike ToString)
+    // and allocates nothing, so the time is mostly the call itself
+    const AngouriMath::Entity two = "2";
+    constexpr int calls = 100000;
+    std::int64_t sum = 0;
+    auto perCall = Measure([&] { for (int i = 0; i < calls; i++) sum += two.AsInteger(); }) / calls;
+    std::cout << "round trip  " << duration<double, std::nano>(perCall).count() << " ns\n";
+    if (sum != 2 * (std::int64_t)calls)
+    {
+        std::cout << "round trip returned a wrong value\n";
+        return 1;
+    }
+
+    if (maxMs > 0.0 && Ms(initialize + first) > maxMs)
+    {
+        std::cout << "cold start exceeds " << maxMs << " ms\n";
+        return 1;
+    }
+    return 0;
+}
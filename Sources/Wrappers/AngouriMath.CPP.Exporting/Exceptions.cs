@@ -22,4 +22,9 @@ namespace AngouriMath.CPP.Exporting
     public sealed class NonExistentObjectAddressingException : ObjectStorageException
     {
     }
+
+    public sealed class NativeCompilationException : Exception
+    {
+        public NativeCompilationException(string message) : base(message) { }
+    }
 }
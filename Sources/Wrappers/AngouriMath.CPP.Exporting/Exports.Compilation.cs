@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using PeterO.Numbers;
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        [UnmanagedCallersOnly(EntryPoint = "entity_compile_fused")]
+        public static NErrorCode CompileFused(NativeArray outputs, NativeArray vars, NativeBuffer* res)
+            => ExceptionEncode(res, (outputs, vars), static e =>
+                NativeBuffer.Alloc(NativeCompiler.Compile(e.outputs.AsEntities(), e.vars.AsEntities()))
+            );
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_compile_boolean")]
+        public static NErrorCode CompileBoolean(ObjRef exprPtr, NativeArray vars, NativeBuffer* res)
+            => ExceptionEncode(res, (exprPtr, vars), static e =>
+                NativeBuffer.Alloc(NativeBooleanCompiler.Compile(e.exprPtr.AsEntity, e.vars.AsEntities()))
+            );
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_compile_rational")]
+        public static NErrorCode CompileRational(ObjRef exprPtr, NativeArray vars, NativeBuffer* instructions, NativeBuffer* constants)
+            => ExceptionEncode((exprPtr, vars, instructions: (IntPtr)instructions, constants: (IntPtr)constants), static e =>
+            {
+                var (program, values) = NativeRationalCompiler.Compile(e.exprPtr.AsEntity, e.vars.AsEntities());
+                *(NativeBuffer*)e.constants = NativeBuffer.Alloc(values);
+                *(NativeBuffer*)e.instructions = NativeBuffer.Alloc(program);
+            });
+
+        /// <summary>
+        /// Exact value of the expression on every row of (numerator, denominator) arguments with
+        /// arbitrary precision, for the rows the native evaluation overflowed on. The status is
+        /// 1 if the value fits into 64 bits, 2 if it does not and 3 if it is not a rational.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_evaluate_rational")]
+        public static NErrorCode EvaluateRational(ObjRef exprPtr, NativeArray vars, IntPtr values, int rows, IntPtr res, IntPtr status)
+            => ExceptionEncode((exprPtr, vars, values, rows, res, status), static e =>
+            {
+                var expr = e.exprPtr.AsEntity;
+                var vars = e.vars.AsEntities();
+                var input = ((long, long)*)e.values;
+                var output = ((long, long)*)e.res;
+                var flags = (byte*)e.status;
+                var substitution = new Dictionary<Variable, Entity>();
+                for (int row = 0; row < e.rows; row++)
+                {
+                    for (int i = 0; i < vars.Length; i++)
+                    {
+                        var (numerator, denominator) = input[(long)row * vars.Length + i];
+                        // the arguments are as the caller passed them, not normalized
+                        substitution[(Variable)vars[i]] = denominator switch
+                        {
+                            0 => Number.Real.NaN,
+                            < 0 => Number.Rational.Create(-EInteger.FromInt64(numerator), -EInteger.FromInt64(denominator)),
+                            _ => Number.Rational.Create(EInteger.FromInt64(numerator), EInteger.FromInt64(denominator))
+                        };
+                    }
+                    var value = expr.Replace(node => node is Variable v && substitution.TryGetValue(v, out var replacement) ? replacement : node).Evaled;
+                    output[row] = (0, 1);
+                    if (value is not Number.Rational rational)
+                        flags[row] = 3;
+                    else if (!rational.ERational.Numerator.CanFitInInt64() || !rational.ERational.Denominator.CanFitInInt64())
+                        flags[row] = 2;
+                    else
+                    {
+                        output[row] = (rational.ERational.Numerator.ToInt64Checked(), rational.ERational.Denominator.ToInt64Checked());
+                        flags[row] = 1;
+                    }
+                }
+            });
+    }
+}
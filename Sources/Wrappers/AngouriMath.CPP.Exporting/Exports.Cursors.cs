@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Cursors
+
+        // A cursor is a handle to a managed enumerator which the caller drains page by page,
+        // so nothing past the last requested page is enumerated or marshalled
+        private static ObjRef CursorOf(IEnumerable<Entity> entities)
+            => ObjStorage<IEnumerator<Entity>>.Alloc(entities.GetEnumerator());
+
+        private static IEnumerable<Entity> Page(IEnumerator<Entity> enumerator, int maxCount)
+        {
+            for (int i = 0; i < maxCount && enumerator.MoveNext(); i++)
+                yield return enumerator.Current;
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_nodes_cursor")]
+        public static NErrorCode EntityNodesCursor(ObjRef exprPtr, ObjRef* res)
+            => ExceptionEncode(res, exprPtr, static exprPtr => CursorOf(exprPtr.AsEntity.Nodes));
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_alternate_cursor")]
+        public static NErrorCode EntityAlternateCursor(ObjRef exprPtr, ObjRef* res)
+            => ExceptionEncode(res, exprPtr, static exprPtr => CursorOf(exprPtr.AsEntity.Alternate(4)));
+
+        /// <summary>
+        /// Next at most <paramref name="maxCount"/> elements of the cursor,
+        /// an empty page means the cursor is exhausted
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "cursor_next_page")]
+        public static NErrorCode CursorNextPage(ObjRef cursor, int maxCount, NativeArray* res)
+            => ExceptionEncode(res, (cursor, maxCount), static e =>
+                NativeArray.Alloc(Page(ObjStorage<IEnumerator<Entity>>.Get(e.cursor), e.maxCount))
+            );
+
+        [UnmanagedCallersOnly(EntryPoint = "free_cursor")]
+        public static NErrorCode FreeCursor(ObjRef cursor)
+            => ExceptionEncode(cursor, static cursor =>
+            {
+                ObjStorage<IEnumerator<Entity>>.Get(cursor).Dispose();
+                ObjStorage<IEnumerator<Entity>>.Dealloc(cursor);
+            });
+
+        #endregion
+    }
+}
@@ -7,7 +7,10 @@
 
 using AngouriMath.Core;
 using System;
+using System.Collections.Generic;
+using System.Linq;
 using System.Runtime.InteropServices;
+using System.Threading;
 using static AngouriMath.Entity;
 
 namespace AngouriMath.CPP.Exporting
@@ -19,13 +22,13 @@ namespace AngouriMath.CPP.Exporting
         [UnmanagedCallersOnly(EntryPoint = "entity_to_string")]
         public static NErrorCode EntityToString(ObjRef exprPtr, IntPtr* res)
             => ExceptionEncode(res, exprPtr,
-                exprPtr => Marshal.StringToHGlobalAnsi(exprPtr.AsEntity.ToString())
+                exprPtr => TracedStringToHGlobal(exprPtr.AsEntity.ToString())
             );
 
         [UnmanagedCallersOnly(EntryPoint = "entity_latexise")]
         public static NErrorCode EntityToLatex(ObjRef exprPtr, IntPtr* res)
             => ExceptionEncode(res, exprPtr,
-                exprPtr => Marshal.StringToHGlobalAnsi(exprPtr.AsEntity.Latexise())
+                exprPtr => TracedStringToHGlobal(exprPtr.AsEntity.Latexise())
             );
 
         #endregion
@@ -123,6 +126,137 @@ namespace AngouriMath.CPP.Exporting
             => ExceptionEncode(res, exprPtr,
                 exprPtr => exprPtr.AsEntity.Simplify()
             );
+
+        // the core does not expose the local cancellation token, so the one set from here is remembered
+        [ThreadStatic] private static CancellationToken localCancellationToken;
+
+        private static void SetLocalCancellationToken(CancellationToken token)
+        {
+            localCancellationToken = token;
+            MathS.Multithreading.SetLocalCancellationToken(token);
+        }
+
+        /// <summary>
+        /// Simplifies with the given level. Every newly rated form counts as an explored
+        /// alternative; once there are more than <paramref name="maxAlternatives"/> of them,
+        /// or if the expression has more than <paramref name="maxNodes"/> nodes, the search
+        /// is abandoned and the shallow <see cref="Entity.InnerSimplified"/> form is returned.
+        /// Zero limits are unbounded.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_simplify_with")]
+        public static NErrorCode EntitySimplifyWith(ObjRef exprPtr, int level, int maxAlternatives, int maxNodes, NativeSimplifyReport* report, ObjRef* res)
+            => ExceptionEncode(res, (exprPtr, level, maxAlternatives, maxNodes, report: (IntPtr)report), static e =>
+            {
+                var expr = e.exprPtr.AsEntity;
+                var result = new NativeSimplifyReport();
+                Entity simplified;
+                if (e.maxNodes > 0 && expr.Nodes.Skip(e.maxNodes).Any())
+                {
+                    result.BudgetExceeded = true;
+                    simplified = expr.InnerSimplified;
+                }
+                else
+                {
+                    var criteria = MathS.Settings.ComplexityCriteria.Value;
+                    using var budget = new CancellationTokenSource();
+                    var explored = 0;
+                    using var _ = MathS.Settings.ComplexityCriteria.Set(form =>
+                    {
+                        if (++explored > e.maxAlternatives && e.maxAlternatives > 0)
+                            budget.Cancel();
+                        return criteria(form);
+                    });
+                    var previousToken = localCancellationToken;
+                    SetLocalCancellationToken(budget.Token);
+                    try
+                    {
+                        simplified = expr.Simplify(e.level);
+                    }
+                    catch (OperationCanceledException) when (budget.IsCancellationRequested)
+                    {
+                        result.BudgetExceeded = true;
+                        simplified = expr.InnerSimplified;
+                    }
+                    finally
+                    {
+                        SetLocalCancellationToken(previousToken);
+                    }
+                    result.AlternativesExplored = explored;
+                }
+                *(NativeSimplifyReport*)e.report = result;
+                return simplified;
+            });
+
+        /// <summary>
+        /// See <see cref="IncrementalSimplifier"/>
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_simplify_incremental")]
+        public static NErrorCode EntitySimplifyIncremental(ObjRef exprPtr, int level, int window, NativeIncrementalReport* report, ObjRef* res)
+            => ExceptionEncode(res, (exprPtr, level, window, report: (IntPtr)report), static e =>
+            {
+                if (e.window < 1)
+                    throw new ArgumentOutOfRangeException(nameof(window), "The window must have at least one level");
+                var counters = new IncrementalSimplifier.Counters();
+                var simplified = IncrementalSimplifier.Simplify(e.exprPtr.AsEntity, e.level, e.window, ref counters);
+                *(NativeIncrementalReport*)e.report = new() { Simplified = counters.Simplified, Reused = counters.Reused };
+                return simplified;
+            });
+
+        [UnmanagedCallersOnly(EntryPoint = "incremental_simplifier_clear")]
+        public static NErrorCode IncrementalSimplifierClear()
+            => ExceptionEncode(0, static _ => IncrementalSimplifier.Clear());
+        #endregion
+
+        #region Substitution
+
+        // Both keep every untouched subtree shared with the original expression
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_substitute")]
+        public static NErrorCode EntitySubstitute(ObjRef exprPtr, ObjRef xPtr, ObjRef valuePtr, ObjRef* res)
+            => ExceptionEncode(res, (exprPtr, xPtr, valuePtr), static e =>
+                e.exprPtr.AsEntity.Substitute(e.xPtr.AsEntity, e.valuePtr.AsEntity));
+
+        /// <summary>
+        /// Substitutes all the variables at once, so a value may contain the other variables
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_substitute_vars")]
+        public static NErrorCode EntitySubstituteVars(ObjRef exprPtr, NativeArray vars, NativeArray values, ObjRef* res)
+            => ExceptionEncode(res, (exprPtr, vars, values), static e =>
+            {
+                var vars = e.vars.AsEntities();
+                var values = e.values.AsEntities();
+                if (vars.Length != values.Length)
+                    throw new ArgumentException("Every variable needs exactly one value");
+                var map = new Dictionary<Variable, Entity>();
+                for (int i = 0; i < vars.Length; i++)
+                    map[(Variable)vars[i]] = values[i];
+                return e.exprPtr.AsEntity.Replace(node => node is Variable v && map.TryGetValue(v, out var value) ? value : node);
+            });
+
+        /// <summary>
+        /// Replaces the given node itself, as opposed to every subtree equal to it, so the node
+        /// must be taken from the expression, e. g. from its nodes or direct children
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_replace_node")]
+        public static NErrorCode EntityReplaceNode(ObjRef exprPtr, ObjRef nodePtr, ObjRef replacementPtr, ObjRef* res)
+            => ExceptionEncode(res, (exprPtr, nodePtr, replacementPtr), static e =>
+            {
+                var expr = e.exprPtr.AsEntity;
+                var node = e.nodePtr.AsEntity;
+                var replacement = e.replacementPtr.AsEntity;
+                var found = false;
+                var replaced = expr.Replace(current =>
+                {
+                    if (!ReferenceEquals(current, node))
+                        return current;
+                    found = true;
+                    return replacement;
+                });
+                if (!found)
+                    throw new ArgumentException("The node is not a part of the expression");
+                return replaced;
+            });
+
         #endregion
     }
 }
\ No newline at end of file
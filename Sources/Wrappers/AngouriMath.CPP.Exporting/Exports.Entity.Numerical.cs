@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using AngouriMath.Core;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Bulk substitution
+
+        private static FastExpression CompileFor(Entity expr, NativeArray vars)
+            => expr.Compile(vars.AsEntities().Select(v => (Variable)v).ToArray());
+
+        /// <summary>
+        /// Evaluates the compiled expression on the given arguments and writes the result
+        /// into <paramref name="dest"/>. Poles, undefined values and evaluation failures are
+        /// reported as an error flag rather than as an exception, so one bad row does not
+        /// abort the whole batch.
+        /// </summary>
+        private static byte EvaluateRow(FastExpression compiled, System.Numerics.Complex[] args, (double, double)* dest)
+        {
+            System.Numerics.Complex value;
+            try
+            {
+                value = compiled.Call(args);
+            }
+            catch (Exception)
+            {
+                *dest = (double.NaN, double.NaN);
+                return 1;
+            }
+            *dest = (value.Real, value.Imaginary);
+            return double.IsFinite(value.Real) && double.IsFinite(value.Imaginary) ? (byte)0 : (byte)1;
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_substitute_many")]
+        public static NErrorCode SubstituteMany(ObjRef exprPtr, NativeArray vars, IntPtr values, int rows, IntPtr res, IntPtr errors)
+            => ExceptionEncode((exprPtr, vars, values, rows, res, errors), static e =>
+            {
+                var compiled = CompileFor(e.exprPtr.AsEntity, e.vars);
+                var input = (double*)e.values;
+                var output = ((double, double)*)e.res;
+                var flags = (byte*)e.errors;
+                var args = new System.Numerics.Complex[e.vars.Length];
+                for (int row = 0; row < e.rows; row++)
+                {
+                    for (int i = 0; i < args.Length; i++)
+                        args[i] = input[(long)row * args.Length + i];
+                    flags[row] = EvaluateRow(compiled, args, output + row);
+                }
+            });
+
+        [UnmanagedCallersOnly(EntryPoint = "entity_substitute_grid")]
+        public static NErrorCode SubstituteGrid(ObjRef exprPtr, NativeArray vars, IntPtr axes, IntPtr axesLengths, IntPtr res, IntPtr errors)
+            => ExceptionEncode((exprPtr, vars, axes, axesLengths, res, errors), static e =>
+            {
+                var compiled = CompileFor(e.exprPtr.AsEntity, e.vars);
+                var axes = (double*)e.axes;
+                var lengths = (int*)e.axesLengths;
+                var output = ((double, double)*)e.res;
+                var flags = (byte*)e.errors;
+                var dims = e.vars.Length;
+
+                // offsets of every axis in the flattened axes buffer
+                var offsets = new long[dims];
+                long rows = 1;
+                for (int i = 0; i < dims; i++)
+                {
+                    if (lengths[i] < 0)
+                        throw new ArgumentOutOfRangeException(nameof(axesLengths), "Axis length cannot be negative");
+                    offsets[i] = i == 0 ? 0 : offsets[i - 1] + lengths[i - 1];
+                    rows *= lengths[i];
+                }
+
+                // the last variable varies fastest, so the output is row-major
+                var indices = new int[dims];
+                var args = new System.Numerics.Complex[dims];
+                for (long row = 0; row < rows; row++)
+                {
+                    for (int i = 0; i < dims; i++)
+                        args[i] = axes[offsets[i] + indices[i]];
+                    flags[row] = EvaluateRow(compiled, args, output + row);
+                    for (int i = dims - 1; i >= 0; i--)
+                    {
+                        if (++indices[i] < lengths[i])
+                            break;
+                        indices[i] = 0;
+                    }
+                }
+            });
+
+        #endregion
+
+        #region Numerical solving
+
+        private static NativeRoot Root(Entity solution)
+        {
+            Entity evaled;
+            try
+            {
+                evaled = solution.Evaled;
+            }
+            catch (Exception)
+            {
+                return new() { Real = double.NaN, Imaginary = double.NaN, Kind = NativeRootKind.Symbolic };
+            }
+            if (evaled is not Number.Complex number)
+                return new() { Real = double.NaN, Imaginary = double.NaN, Kind = NativeRootKind.Symbolic };
+            var (re, im) = ((double)number.RealPart, (double)number.ImaginaryPart);
+            return double.IsFinite(re) && double.IsFinite(im)
+                ? new() { Real = re, Imaginary = im, Kind = NativeRootKind.Exact }
+                : new() { Real = double.NaN, Imaginary = double.NaN, Kind = NativeRootKind.NonFinite };
+        }
+
+        /// <summary>
+        /// Appends the roots of one equation. If the analytical solver gives up, that is,
+        /// returns a set which is not finite or whose every element is symbolic, and the
+        /// equation has no other variables, the Newton solver is tried.
+        /// </summary>
+        private static void SolveNumeric(Entity equation, Variable var, List<NativeRoot> roots)
+        {
+            var solutions = equation.SolveEquation(var);
+            var first = roots.Count;
+            var gaveUp = true;
+            if (solutions is Set.FiniteSet finite)
+            {
+                // the analytical solver already tries Newton when it finds nothing
+                if (finite.Count == 0)
+                    return;
+                foreach (var solution in finite)
+                {
+                    var root = Root(solution);
+                    gaveUp &= root.Kind == NativeRootKind.Symbolic;
+                    roots.Add(root);
+                }
+            }
+            if (!gaveUp)
+                return;
+            var found = false;
+            if (equation.Vars.Count == 1 && equation.Vars[0] == var)
+                foreach (var newtonRoot in equation.SolveNt(var))
+                {
+                    // the numeric roots replace the symbolic placeholders
+                    if (!found)
+                        roots.RemoveRange(first, roots.Count - first);
+                    roots.Add(new() { Real = (double)newtonRoot.RealPart, Imaginary = (double)newtonRoot.ImaginaryPart, Kind = NativeRootKind.Newton });
+                    found = true;
+                }
+            if (!found && solutions is not Set.FiniteSet)
+                roots.Add(new() { Real = double.NaN, Imaginary = double.NaN, Kind = NativeRootKind.Symbolic });
+        }
+
+        /// <summary>
+        /// Solves every equation over <paramref name="varPtr"/> and writes all the roots
+        /// into one buffer; the roots of the i-th equation are in [offsets[i], offsets[i + 1]).
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_solve_equations_numeric")]
+        public static NErrorCode SolveEquationsNumeric(NativeArray equations, ObjRef varPtr, NativeBuffer* roots, NativeBuffer* offsets)
+            => ExceptionEncode((equations, varPtr, roots: (IntPtr)roots, offsets: (IntPtr)offsets), static e =>
+            {
+                var var = (Variable)e.varPtr.AsEntity;
+                var res = new List<NativeRoot>();
+                var equations = e.equations.AsEntities();
+                var bounds = new int[equations.Length + 1];
+                for (int i = 0; i < equations.Length; i++)
+                {
+                    SolveNumeric(equations[i], var, res);
+                    bounds[i + 1] = res.Count;
+                }
+                *(NativeBuffer*)e.roots = NativeBuffer.Alloc(res.ToArray());
+                *(NativeBuffer*)e.offsets = NativeBuffer.Alloc(bounds);
+            });
+
+        #endregion
+
+        #region Polynomials
+
+        private static NativePolynomialTerm Term(long power, Entity coefficient)
+        {
+            if (coefficient.Evaled is not Number.Complex number)
+                throw new InvalidCastException($"The coefficient {coefficient} at power {power} is not numeric");
+            var term = new NativePolynomialTerm { Power = power, Real = (double)number.RealPart, Imaginary = (double)number.ImaginaryPart };
+            if (number is Number.Rational rational
+                && rational.ERational.Numerator.CanFitInInt64()
+                && rational.ERational.Denominator.CanFitInInt64())
+            {
+                term.Numerator = rational.ERational.Numerator.ToInt64Checked();
+                term.Denominator = rational.ERational.Denominator.ToInt64Checked();
+                term.IsRational = true;
+            }
+            return term;
+        }
+
+        /// <summary>
+        /// Sparse numeric coefficients of the polynomial over <paramref name="varPtr"/>,
+        /// sorted by power. Throws if the expression is not a polynomial or some
+        /// coefficient depends on other variables.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_as_polynomial")]
+        public static NErrorCode AsPolynomial(ObjRef exprPtr, ObjRef varPtr, NativeBuffer* res)
+            => ExceptionEncode(res, (exprPtr, varPtr), static e =>
+            {
+                var expr = e.exprPtr.AsEntity;
+                var var = (Variable)e.varPtr.AsEntity;
+                if (!MathS.Utils.TryGetPolynomial(expr, var, out var monomials))
+                    throw new InvalidCastException($"{expr} is not a polynomial over {var}");
+                var terms = new List<NativePolynomialTerm>();
+                foreach (var (power, coefficient) in monomials.OrderBy(m => m.Key))
+                {
+                    if (power.Sign < 0 || !power.CanFitInInt32())
+                        throw new InvalidCastException($"{expr} has a term of power {power} over {var}");
+                    var term = Term(power.ToInt64Checked(), coefficient);
+                    if (term.Real != 0 || term.Imaginary != 0)
+                        terms.Add(term);
+                }
+                return NativeBuffer.Alloc(terms.ToArray());
+            });
+
+        #endregion
+
+        #region Taylor surrogates
+
+        /// <summary>
+        /// Numeric Taylor coefficients f^(k)(point) / k! for k up to <paramref name="order"/>,
+        /// as (real, imaginary) pairs, and the compiled derivative of order + 1 over the variable,
+        /// from which the caller estimates the Lagrange remainder.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "entity_taylor")]
+        public static NErrorCode Taylor(ObjRef exprPtr, ObjRef varPtr, double point, int order, NativeBuffer* coefficients, NativeBuffer* remainder)
+            => ExceptionEncode((exprPtr, varPtr, point, order, coefficients: (IntPtr)coefficients, remainder: (IntPtr)remainder), static e =>
+            {
+                if (e.order < 0)
+                    throw new ArgumentOutOfRangeException(nameof(order), "The order cannot be negative");
+                var var = (Variable)e.varPtr.AsEntity;
+                var derivative = e.exprPtr.AsEntity;
+                var res = new (double, double)[e.order + 1];
+                System.Numerics.Complex factorial = 1;
+                for (int k = 0; k <= e.order; k++)
+                {
+                    if (k > 0)
+                    {
+                        derivative = derivative.Differentiate(var);
+                        factorial *= k;
+                    }
+                    if (derivative.Substitute(var, e.point).Evaled is not Number.Complex value)
+                        throw new InvalidCastException($"The derivative of order {k} cannot be evaluated at {e.point}");
+                    var coefficient = value.ToNumerics() / factorial;
+                    res[k] = (coefficient.Real, coefficient.Imaginary);
+                }
+                var next = derivative.Differentiate(var);
+                *(NativeBuffer*)e.remainder = NativeBuffer.Alloc(NativeCompiler.Compile(new[] { next }, new Entity[] { var }));
+                *(NativeBuffer*)e.coefficients = NativeBuffer.Alloc(res);
+            });
+
+        #endregion
+    }
+}
@@ -36,6 +36,12 @@ namespace AngouriMath.CPP.Exporting
                 exprPtr => NativeArray.Alloc(exprPtr.AsEntity.VarsAndConsts.Select(v => (Entity)v))
             );
 
+        [UnmanagedCallersOnly(EntryPoint = "entity_structural_hash")]
+        public static NErrorCode EntityStructuralHash(ObjRef exprPtr, ulong* res)
+            => ExceptionEncode(res, exprPtr,
+                exprPtr => StructuralHash.Of(exprPtr.AsEntity)
+            );
+
         [UnmanagedCallersOnly(EntryPoint = "entity_evaled")]
         public static NErrorCode EntityEvaled(ObjRef exprPtr, ObjRef* res)
             => ExceptionEncode(res, exprPtr,
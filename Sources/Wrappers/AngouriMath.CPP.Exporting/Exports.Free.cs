@@ -31,6 +31,10 @@ namespace AngouriMath.CPP.Exporting
         public static NErrorCode FreeNativeArray(NativeArray arr)
             => ExceptionEncode(arr, static arr => arr.Free() );
 
+        [UnmanagedCallersOnly(EntryPoint = "free_native_buffer")]
+        public static NErrorCode FreeNativeBuffer(NativeBuffer buffer)
+            => ExceptionEncode(buffer, static buffer => buffer.Free() );
+
         [UnmanagedCallersOnly(EntryPoint = "free_string")]
         public static NErrorCode FreeNativeArray(IntPtr s)
             => ExceptionEncode(s, static s => Free(s) );
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+using System.Runtime;
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Garbage collector
+
+        // The mode, concurrency and memory conservation are read from the DOTNET_gc* environment
+        // variables when the runtime starts, so the caller sets them before the first call;
+        // the rest can be changed at any time.
+
+        // The GC reports its configuration under the internal name of a setting (e.g. ConcurrentGC
+        // for DOTNET_gcConcurrent); a setting it does not report is read from the runtime config
+        private static long GcConfig(string reportedName, string publicName, long defaultValue)
+        {
+            if (GC.GetConfigurationVariables().TryGetValue(reportedName, out var value))
+                return value switch
+                {
+                    bool flag => flag ? 1 : 0,
+                    long number => number,
+                    ulong number => (long)number,
+                    int number => number,
+                    _ => defaultValue
+                };
+            return AppContext.GetData(publicName) switch
+            {
+                bool flag => flag ? 1 : 0,
+                string text when bool.TryParse(text, out var flag) => flag ? 1 : 0,
+                string text when long.TryParse(text, out var number) => number,
+                _ => defaultValue
+            };
+        }
+
+        private static long Nanoseconds(TimeSpan span)
+            => span.Ticks * (1_000_000_000 / TimeSpan.TicksPerSecond);
+
+        [UnmanagedCallersOnly(EntryPoint = "gc_info")]
+        public static NErrorCode GcInfo(NativeGcInfo* res)
+            => ExceptionEncode(res, 0, static _ =>
+            {
+                var info = GC.GetGCMemoryInfo(GCKind.Any);
+                var pauses = info.PauseDurations;
+                return new NativeGcInfo
+                {
+                    IsServer = GCSettings.IsServerGC,
+                    IsConcurrent = GcConfig("ConcurrentGC", "System.GC.Concurrent", 1) != 0,
+                    LatencyMode = (int)GCSettings.LatencyMode,
+                    ConserveMemory = (int)GcConfig("GCConserveMem", "System.GC.ConserveMemory", 0),
+                    HeapHardLimitBytes = info.TotalAvailableMemoryBytes,
+                    HeapSizeBytes = info.HeapSizeBytes,
+                    CommittedBytes = info.TotalCommittedBytes,
+                    FragmentedBytes = info.FragmentedBytes,
+                    TotalAllocatedBytes = GC.GetTotalAllocatedBytes(),
+                    Gen0Collections = GC.CollectionCount(0),
+                    Gen1Collections = GC.CollectionCount(1),
+                    Gen2Collections = GC.CollectionCount(2),
+                    TotalPauseNanoseconds = Nanoseconds(GC.GetTotalPauseDuration()),
+                    LastPauseNanoseconds = pauses.Length > 0 ? Nanoseconds(pauses[0]) : 0,
+                    PauseTimePercentage = info.PauseTimePercentage,
+                };
+            });
+
+        /// <summary>
+        /// Values of <see cref="GCLatencyMode"/>, except for NoGCRegion, which cannot be set
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "gc_set_latency_mode")]
+        public static NErrorCode GcSetLatencyMode(int mode)
+            => ExceptionEncode(mode, static mode => GCSettings.LatencyMode = (GCLatencyMode)mode);
+
+        /// <summary>
+        /// Allocations beyond the limit throw <see cref="OutOfMemoryException"/>, which reaches the
+        /// caller as an error code, instead of growing the process until the OS kills it
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "gc_set_heap_hard_limit")]
+        public static NErrorCode GcSetHeapHardLimit(ulong bytes)
+            => ExceptionEncode(bytes, static bytes =>
+            {
+                AppContext.SetData("GCHeapHardLimit", bytes);
+                GC.RefreshMemoryLimit();
+            });
+
+        /// <summary>
+        /// Full blocking collection. A compacting one also compacts the large object heap
+        /// and decommits the freed memory, so the heap shrinks back after a batch.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "gc_collect")]
+        public static NErrorCode GcCollect(NativeBool compact)
+            => ExceptionEncode(compact, static compact =>
+            {
+                if (compact)
+                {
+                    GCSettings.LargeObjectHeapCompactionMode = GCLargeObjectHeapCompactionMode.CompactOnce;
+                    GC.Collect(GC.MaxGeneration, GCCollectionMode.Aggressive, blocking: true, compacting: true);
+                }
+                else
+                    GC.Collect(GC.MaxGeneration, GCCollectionMode.Forced, blocking: true);
+                GC.WaitForPendingFinalizers();
+            });
+
+        #endregion
+    }
+}
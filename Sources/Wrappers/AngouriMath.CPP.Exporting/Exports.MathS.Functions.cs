@@ -6,7 +6,10 @@
 //
 
 using System;
+using System.Collections.Generic;
+using System.Linq;
 using System.Runtime.InteropServices;
+using static AngouriMath.Entity;
 
 namespace AngouriMath.CPP.Exporting
 {
@@ -16,11 +19,29 @@ namespace AngouriMath.CPP.Exporting
         public static NErrorCode Parse(IntPtr strPtr, ObjRef* res)
             => ExceptionEncode(res, strPtr, static strPtr =>
             {
-                var str = Marshal.PtrToStringAnsi(strPtr);
+                string? str;
+                using (new TraceSpan("Marshal.PtrToStringAnsi"))
+                    str = Marshal.PtrToStringAnsi(strPtr);
                 if (str is null) throw new ArgumentNullException(nameof(strPtr), "Can't parse a null string.");
                 return ObjStorage<Entity>.Alloc(str);
             });
 
+        /// <summary>
+        /// Builds the expression the native parser has parsed. With explicit parsing only,
+        /// an omitted operator is an error, which the full parser reports.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "maths_build_parsed")]
+        public static NErrorCode BuildParsed(IntPtr strPtr, NativeBuffer program, NativeBool implicitOperators, ObjRef* res)
+            => ExceptionEncode(res, (strPtr, program, implicitOperators), static e =>
+            {
+                var str = Marshal.PtrToStringAnsi(e.strPtr);
+                if (str is null) throw new ArgumentNullException(nameof(strPtr), "Can't parse a null string.");
+                if (e.implicitOperators && MathS.Settings.ExplicitParsingOnly.Value)
+                    return ObjStorage<Entity>.Alloc(MathS.FromString(str));
+                var nodes = new ReadOnlySpan<NativeParseNode>((void*)e.program.Ptr, e.program.Length);
+                return ObjStorage<Entity>.Alloc(ParsedExpressionBuilder.Build(str, nodes));
+            });
+
         [UnmanagedCallersOnly(EntryPoint = "matrix_from_vector_of_vectors")]
         public static NErrorCode MatrixFromVectorOfVectors(NativeArray arr, ObjRef* res)
             => ExceptionEncode(res, arr, static arr =>
@@ -42,5 +63,24 @@ namespace AngouriMath.CPP.Exporting
             => ExceptionEncode(res, m, static m 
                 => NativeArray.Alloc((Entity.Set.FiniteSet)m.AsEntity)
             );
+
+        /// <summary>
+        /// Solves the system and returns the solution matrix flattened row-major, one row
+        /// per solution and one column per variable. No solution gives an empty array.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "equation_system_solve")]
+        public static NErrorCode EquationSystemSolve(NativeArray equations, NativeArray vars, int* solutionCount, NativeArray* res)
+            => ExceptionEncode(res, (equations, vars, solutionCount: (IntPtr)solutionCount), static e =>
+            {
+                var vars = e.vars.AsEntities().Select(v => (Variable)v).ToArray();
+                var solutions = MathS.Equations(e.equations.AsEntities()).Solve(vars);
+                *(int*)e.solutionCount = solutions?.RowCount ?? 0;
+                var flattened = new List<Entity>();
+                if (solutions is not null)
+                    for (int i = 0; i < solutions.RowCount; i++)
+                        for (int j = 0; j < solutions.ColumnCount; j++)
+                            flattened.Add(solutions[i, j]);
+                return NativeArray.Alloc(flattened);
+            });
     }
 }
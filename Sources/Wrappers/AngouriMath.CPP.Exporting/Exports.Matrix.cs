@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+using System.Runtime.InteropServices;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Numeric buffers
+
+        // Buffers are row-major; complex buffers hold (real, imaginary) pairs
+
+        [UnmanagedCallersOnly(EntryPoint = "matrix_from_buffer")]
+        public static NErrorCode MatrixFromBuffer(IntPtr values, int rows, int columns, NativeBool isComplex, ObjRef* res)
+            => ExceptionEncode(res, (values, rows, columns, isComplex), static e =>
+            {
+                if (e.rows <= 0 || e.columns <= 0)
+                    throw new ArgumentOutOfRangeException(nameof(rows), "A matrix should have at least one row and one column");
+                var real = (double*)e.values;
+                var complex = ((double re, double im)*)e.values;
+                Entity[,] elements = new Entity[e.rows, e.columns];
+                for (int i = 0; i < e.rows; i++)
+                    for (int j = 0; j < e.columns; j++)
+                    {
+                        var id = (long)i * e.columns + j;
+                        elements[i, j] = e.isComplex
+                            ? (Number.Complex)new System.Numerics.Complex(complex[id].re, complex[id].im)
+                            : real[id];
+                    }
+                return ObjStorage<Entity>.Alloc(MathS.Matrix(elements));
+            });
+
+        [UnmanagedCallersOnly(EntryPoint = "matrix_shape")]
+        public static NErrorCode MatrixShape(ObjRef matrix, int* rows, int* columns)
+            => ExceptionEncode((matrix, rows: (IntPtr)rows, columns: (IntPtr)columns), static e =>
+            {
+                var m = (Matrix)e.matrix.AsEntity;
+                *(int*)e.rows = m.RowCount;
+                *(int*)e.columns = m.ColumnCount;
+            });
+
+        /// <summary>
+        /// Writes the evaluated elements into the buffer, which must fit RowCount x ColumnCount
+        /// elements. For a real buffer, an element with a non-zero imaginary part is an error.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "matrix_to_buffer")]
+        public static NErrorCode MatrixToBuffer(ObjRef matrix, NativeBool isComplex, IntPtr res)
+            => ExceptionEncode((matrix, isComplex, res), static e =>
+            {
+                var m = (Matrix)e.matrix.AsEntity;
+                var real = (double*)e.res;
+                var complex = ((double re, double im)*)e.res;
+                for (int i = 0; i < m.RowCount; i++)
+                    for (int j = 0; j < m.ColumnCount; j++)
+                    {
+                        var id = (long)i * m.ColumnCount + j;
+                        var number = (Number.Complex)m[i, j].Evaled;
+                        if (e.isComplex)
+                            complex[id] = ((double)number.RealPart, (double)number.ImaginaryPart);
+                        else if (number is Number.Real realNumber)
+                            real[id] = (double)realNumber;
+                        else
+                            throw new InvalidCastException($"The element {m[i, j]} at ({i}, {j}) is not real");
+                    }
+            });
+
+        #endregion
+
+        #region Compilation
+
+        /// <summary>
+        /// Compiles all the elements into one program, the i-th output is the i-th element
+        /// in row-major order. No element handles cross the boundary.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "matrix_compile")]
+        public static NErrorCode MatrixCompile(ObjRef matrix, NativeArray vars, NativeBuffer* res)
+            => ExceptionEncode(res, (matrix, vars), static e =>
+            {
+                var m = (Matrix)e.matrix.AsEntity;
+                var elements = new Entity[m.RowCount * m.ColumnCount];
+                for (int i = 0; i < m.RowCount; i++)
+                    for (int j = 0; j < m.ColumnCount; j++)
+                        elements[i * m.ColumnCount + j] = m[i, j];
+                return NativeBuffer.Alloc(NativeCompiler.Compile(elements, e.vars.AsEntities()));
+            });
+
+        #endregion
+    }
+}
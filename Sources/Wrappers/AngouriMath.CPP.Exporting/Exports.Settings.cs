@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using PeterO.Numbers;
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Settings
+
+        /// <summary>
+        /// Stable hash of the settings of the calling thread which affect simplification and
+        /// parsing, together with the version of AngouriMath. Results computed under equal
+        /// fingerprints are interchangeable, even between processes.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "settings_fingerprint")]
+        public static NErrorCode SettingsFingerprint(ulong* res)
+            => ExceptionEncode(res, 0, static _ => CurrentSettingsFingerprint());
+
+        internal static ulong CurrentSettingsFingerprint()
+        {
+            var context = MathS.Settings.DecimalPrecisionContext.Value;
+            var criteria = MathS.Settings.ComplexityCriteria.Value.Method;
+            var description = string.Join("\n",
+                typeof(Entity).Assembly.GetName().Version,
+                MathS.Settings.DowncastingEnabled.Value,
+                MathS.Settings.ExplicitParsingOnly.Value,
+                MathS.Settings.FloatToRationalIterCount.Value,
+                MathS.Settings.MaxAbsNumeratorOrDenominatorValue.Value,
+                MathS.Settings.PrecisionErrorCommon.Value,
+                MathS.Settings.PrecisionErrorZeroRange.Value,
+                MathS.Settings.AllowNewton.Value,
+                MathS.Settings.MaxExpansionTermCount.Value,
+                context.Precision, context.Rounding, context.EMin, context.EMax,
+                criteria.DeclaringType?.FullName + "." + criteria.Name);
+            return StructuralHash.Combine(StructuralHash.OffsetBasis, description);
+        }
+
+        // Settings are thread static on the managed side, so is the stack of the
+        // overrides pushed by the calling thread; scopes end in reverse order
+        [ThreadStatic] private static List<IDisposable[]>? settingsScopes;
+
+        // The shortest decimal which round-trips, so that 1e-6 is not taken as its binary approximation
+        private static EDecimal ToEDecimal(double value)
+            => double.IsFinite(value) && value >= 0
+                ? EDecimal.FromString(value.ToString("R", CultureInfo.InvariantCulture))
+                : throw new ArgumentOutOfRangeException(nameof(value), $"A precision must be a non-negative finite number, got {value}");
+
+        [UnmanagedCallersOnly(EntryPoint = "settings_get")]
+        public static NErrorCode SettingsGet(NativeSettings* res)
+            => ExceptionEncode(res, 0, static _ =>
+            {
+                var newton = MathS.Settings.NewtonSolver.Value;
+                var maxValue = MathS.Settings.MaxAbsNumeratorOrDenominatorValue.Value;
+                return new NativeSettings
+                {
+                    Mask = NativeSettingsMask.All,
+                    FloatToRationalIterCount = MathS.Settings.FloatToRationalIterCount.Value,
+                    MaxAbsNumeratorOrDenominatorValue = maxValue.CanFitInInt64() ? maxValue.ToInt64Checked() : long.MaxValue,
+                    PrecisionErrorCommon = MathS.Settings.PrecisionErrorCommon.Value.ToDouble(),
+                    PrecisionErrorZeroRange = MathS.Settings.PrecisionErrorZeroRange.Value.ToDouble(),
+                    AllowNewton = MathS.Settings.AllowNewton.Value,
+                    DowncastingEnabled = MathS.Settings.DowncastingEnabled.Value,
+                    ExplicitParsingOnly = MathS.Settings.ExplicitParsingOnly.Value,
+                    NewtonPrecision = newton.Precision,
+                    MaxExpansionTermCount = MathS.Settings.MaxExpansionTermCount.Value,
+                    NewtonFromRe = newton.From.Re.ToDouble(),
+                    NewtonFromIm = newton.From.Im.ToDouble(),
+                    NewtonToRe = newton.To.Re.ToDouble(),
+                    NewtonToIm = newton.To.Im.ToDouble(),
+                    NewtonStepsRe = newton.StepCount.Re,
+                    NewtonStepsIm = newton.StepCount.Im,
+                };
+            });
+
+        /// <summary>
+        /// Applies the overrides in the mask to the calling thread until
+        /// <see cref="SettingsPop"/> is called with the returned depth
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "settings_push")]
+        public static NErrorCode SettingsPush(NativeSettings* overrides, int* depth)
+            => ExceptionEncode(depth, (IntPtr)overrides, static ptr =>
+            {
+                var o = *(NativeSettings*)ptr;
+                // validated before anything is applied, so a failed push leaves no trace
+                var precisionErrorCommon = o.Mask.HasFlag(NativeSettingsMask.PrecisionErrorCommon) ? ToEDecimal(o.PrecisionErrorCommon) : null;
+                var precisionErrorZeroRange = o.Mask.HasFlag(NativeSettingsMask.PrecisionErrorZeroRange) ? ToEDecimal(o.PrecisionErrorZeroRange) : null;
+                if (o.Mask.HasFlag(NativeSettingsMask.FloatToRationalIterCount) && o.FloatToRationalIterCount < 0)
+                    throw new ArgumentOutOfRangeException(nameof(o.FloatToRationalIterCount), "The iteration count cannot be negative");
+                if (o.Mask.HasFlag(NativeSettingsMask.MaxAbsNumeratorOrDenominatorValue) && o.MaxAbsNumeratorOrDenominatorValue <= 0)
+                    throw new ArgumentOutOfRangeException(nameof(o.MaxAbsNumeratorOrDenominatorValue), "The bound must be positive");
+                if (o.Mask.HasFlag(NativeSettingsMask.NewtonSolver) && (o.NewtonStepsRe <= 0 || o.NewtonStepsIm <= 0 || o.NewtonPrecision <= 0))
+                    throw new ArgumentOutOfRangeException(nameof(o.NewtonStepsRe), "The step counts and the precision of the Newton solver must be positive");
+
+                var units = new List<IDisposable>();
+                if (precisionErrorCommon is not null)
+                    units.Add(MathS.Settings.PrecisionErrorCommon.Set(precisionErrorCommon));
+                if (precisionErrorZeroRange is not null)
+                    units.Add(MathS.Settings.PrecisionErrorZeroRange.Set(precisionErrorZeroRange));
+                if (o.Mask.HasFlag(NativeSettingsMask.FloatToRationalIterCount))
+                    units.Add(MathS.Settings.FloatToRationalIterCount.Set(o.FloatToRationalIterCount));
+                if (o.Mask.HasFlag(NativeSettingsMask.MaxAbsNumeratorOrDenominatorValue))
+                    units.Add(MathS.Settings.MaxAbsNumeratorOrDenominatorValue.Set(EInteger.FromInt64(o.MaxAbsNumeratorOrDenominatorValue)));
+                if (o.Mask.HasFlag(NativeSettingsMask.AllowNewton))
+                    units.Add(MathS.Settings.AllowNewton.Set(o.AllowNewton));
+                if (o.Mask.HasFlag(NativeSettingsMask.NewtonSolver))
+                    units.Add(MathS.Settings.NewtonSolver.Set(new MathS.Settings.NewtonSetting
+                    {
+                        From = (EDecimal.FromDouble(o.NewtonFromRe), EDecimal.FromDouble(o.NewtonFromIm)),
+                        To = (EDecimal.FromDouble(o.NewtonToRe), EDecimal.FromDouble(o.NewtonToIm)),
+                        StepCount = (o.NewtonStepsRe, o.NewtonStepsIm),
+                        Precision = o.NewtonPrecision,
+                    }));
+                if (o.Mask.HasFlag(NativeSettingsMask.DowncastingEnabled))
+                    units.Add(MathS.Settings.DowncastingEnabled.Set(o.DowncastingEnabled));
+                if (o.Mask.HasFlag(NativeSettingsMask.ExplicitParsingOnly))
+                    units.Add(MathS.Settings.ExplicitParsingOnly.Set(o.ExplicitParsingOnly));
+                if (o.Mask.HasFlag(NativeSettingsMask.MaxExpansionTermCount))
+                    units.Add(MathS.Settings.MaxExpansionTermCount.Set(o.MaxExpansionTermCount));
+
+                settingsScopes ??= new();
+                settingsScopes.Add(units.ToArray());
+                return settingsScopes.Count;
+            });
+
+        [UnmanagedCallersOnly(EntryPoint = "settings_pop")]
+        public static NErrorCode SettingsPop(int depth)
+            => ExceptionEncode(depth, static depth =>
+            {
+                if (settingsScopes is null || settingsScopes.Count != depth)
+                    throw new InvalidOperationException($"Settings scope {depth} is not the innermost scope of the calling thread");
+                var units = settingsScopes[^1];
+                settingsScopes.RemoveAt(settingsScopes.Count - 1);
+                for (int i = units.Length - 1; i >= 0; i--)
+                    units[i].Dispose();
+            });
+
+        #endregion
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Startup
+
+        // Every phase is a separate export, so the caller can time them one by one.
+        // The first call of any export initializes the runtime, so this one does nothing.
+        [UnmanagedCallersOnly(EntryPoint = "startup_runtime")]
+        public static NErrorCode StartupRuntime()
+            => NErrorCode.Ok;
+
+        // Runs the static initialization of MathS and the settings of the calling thread
+        [UnmanagedCallersOnly(EntryPoint = "startup_settings")]
+        public static NErrorCode StartupSettings()
+            => ExceptionEncode(0, static _ =>
+            {
+                _ = MathS.pi;
+                _ = MathS.Settings.DowncastingEnabled.Value;
+                _ = MathS.Settings.PrecisionErrorZeroRange.Value;
+                _ = MathS.Settings.DecimalPrecisionContext.Value;
+                _ = MathS.Settings.ComplexityCriteria.Value;
+            });
+
+        // Builds the lexer and parser tables by parsing expressions which
+        // touch most of the grammar
+        [UnmanagedCallersOnly(EntryPoint = "startup_parser")]
+        public static NErrorCode StartupParser()
+            => ExceptionEncode(0, static _ =>
+            {
+                _ = MathS.FromString("sin(x)^2 + log(2, y) / 3! - sqrt(-1) * arctan(z) + 2.5i");
+                _ = MathS.FromString("x > 2 and y = 3 or not z");
+            });
+
+        [UnmanagedCallersOnly(EntryPoint = "startup_simplifier")]
+        public static NErrorCode StartupSimplifier()
+            => ExceptionEncode(0, static _ =>
+            {
+                _ = MathS.FromString("sin(x)^2 + cos(x)^2 + (a + b)(a - b) + 2 / 4").Simplify();
+            });
+
+        #endregion
+    }
+}
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+using System.Collections.Concurrent;
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    unsafe partial class Exports
+    {
+        #region Tracing
+
+        private static delegate* unmanaged<IntPtr, int, void> traceSink;
+
+        // The sink keeps the name pointers, so every name is converted once and never freed
+        private static readonly ConcurrentDictionary<string, IntPtr> traceNames = new();
+
+        /// <summary>
+        /// Sets the native function which records the spans, null disables tracing.
+        /// Spans are reported on the thread which made the call.
+        /// </summary>
+        [UnmanagedCallersOnly(EntryPoint = "tracing_set_sink")]
+        public static NErrorCode TracingSetSink(IntPtr sink)
+            => ExceptionEncode(sink, static sink => traceSink = (delegate* unmanaged<IntPtr, int, void>)sink);
+
+        /// <summary>
+        /// Reports a span from construction to <see cref="Dispose"/> to the sink if there is one.
+        /// Must be disposed on the thread it was created on.
+        /// </summary>
+        internal readonly struct TraceSpan : IDisposable
+        {
+            private readonly IntPtr name;
+
+            internal TraceSpan(string name)
+            {
+                var sink = traceSink;
+                if (sink == null)
+                {
+                    this.name = IntPtr.Zero;
+                    return;
+                }
+                this.name = traceNames.GetOrAdd(name, static name => Marshal.StringToHGlobalAnsi(name));
+                sink(this.name, 0);
+            }
+
+            public void Dispose()
+            {
+                var sink = traceSink;
+                if (name != IntPtr.Zero && sink != null)
+                    sink(name, 1);
+            }
+        }
+
+        internal static IntPtr TracedStringToHGlobal(string str)
+        {
+            using var _ = new TraceSpan("Marshal.StringToHGlobalAnsi");
+            return Marshal.StringToHGlobalAnsi(str);
+        }
+
+        #endregion
+    }
+}
@@ -12,15 +12,18 @@
  */
 
 using System;
+using System.Runtime.CompilerServices;
 
 namespace AngouriMath.CPP.Exporting
 {
     internal static unsafe partial class Exports
     {
-        internal static NErrorCode ExceptionEncode<TIn, TOut>(TOut* destination, TIn input, Func<TIn, TOut> func)
+        // The span of every export is named after it, see Exports.Tracing.cs
+        internal static NErrorCode ExceptionEncode<TIn, TOut>(TOut* destination, TIn input, Func<TIn, TOut> func, [CallerMemberName] string export = "")
             where TIn : unmanaged
             where TOut : unmanaged
         {
+            using var _ = new TraceSpan(export);
             try
             {
                 *destination = func(input);
@@ -32,8 +35,9 @@ namespace AngouriMath.CPP.Exporting
             }
         }
 
-        internal static NErrorCode ExceptionEncode<TIn>(TIn input, Action<TIn> func)
+        internal static NErrorCode ExceptionEncode<TIn>(TIn input, Action<TIn> func, [CallerMemberName] string export = "")
         {
+            using var _ = new TraceSpan(export);
             try
             {
                 func(input);
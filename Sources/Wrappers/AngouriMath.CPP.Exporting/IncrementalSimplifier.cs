@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.CompilerServices;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Simplifies an expression bottom up, one node at a time, and remembers the result
+        /// of every subtree. A node is simplified together with the first <c>window</c> levels
+        /// of its already simplified children, deeper subtrees are replaced by placeholder
+        /// variables for that. After an edit which keeps the rest of the tree shared, only the
+        /// nodes on the path from the edit to the root miss the cache, so the cost depends on
+        /// the size of the edit and the depth, not on the size of the expression.
+        /// </summary>
+        internal static class IncrementalSimplifier
+        {
+            private sealed record Result(ulong Key, Entity Simplified);
+
+            // subtrees shared with the previous version of the expression are found by reference,
+            // structurally equal ones created anew by their hash
+            private static readonly ConditionalWeakTable<Entity, Result> byReference = new();
+            private static readonly Dictionary<ulong, (Entity Input, Entity Simplified)> byHash = new();
+            private const int MaxHashedResults = 1 << 16;
+
+            internal struct Counters
+            {
+                internal int Simplified;
+                internal int Reused;
+            }
+
+            internal static Entity Simplify(Entity expr, int level, int window, ref Counters counters)
+            {
+                var options = StructuralHash.Combine(CurrentSettingsFingerprint(), (ulong)level * 31 + (ulong)window);
+                return Simplify(expr, level, window, options, ref counters);
+            }
+
+            internal static void Clear()
+            {
+                byReference.Clear();
+                lock (byHash)
+                    byHash.Clear();
+            }
+
+            private static Entity Simplify(Entity expr, int level, int window, ulong options, ref Counters counters)
+            {
+                if (expr.DirectChildren.Count == 0)
+                    return expr;
+                if (byReference.TryGetValue(expr, out var known) && known.Key == options)
+                {
+                    counters.Reused++;
+                    return known.Simplified;
+                }
+                var key = StructuralHash.Combine(StructuralHash.Of(expr), options);
+                lock (byHash)
+                    if (byHash.TryGetValue(key, out var hashed) && hashed.Input == expr)
+                    {
+                        counters.Reused++;
+                        byReference.AddOrUpdate(expr, new(options, hashed.Simplified));
+                        return hashed.Simplified;
+                    }
+
+                Entity simplified;
+                var children = new Entity[expr.DirectChildren.Count];
+                for (int i = 0; i < children.Length; i++)
+                    children[i] = Simplify(expr.DirectChildren[i], level, window, options, ref counters);
+                if (WithChildren(expr, children) is { } rebuilt)
+                    simplified = SimplifyWindow(rebuilt, level, window);
+                else
+                    // nodes with non-entity fields are simplified as a whole
+                    simplified = expr.Simplify(level);
+                counters.Simplified++;
+
+                byReference.AddOrUpdate(expr, new(options, simplified));
+                lock (byHash)
+                {
+                    if (byHash.Count >= MaxHashedResults)
+                        byHash.Clear();
+                    byHash[key] = (expr, simplified);
+                }
+                return simplified;
+            }
+
+            private static Entity SimplifyWindow(Entity expr, int level, int window)
+            {
+                var names = new HashSet<string>();
+                CollectNames(expr, window, names);
+                var holes = new Dictionary<Entity, Variable>();
+                var cut = Cut(expr, window, holes, names);
+                if (holes.Count == 0)
+                    return cut.Simplify(level);
+                var back = holes.ToDictionary(hole => hole.Value, hole => hole.Key);
+                // one pass, so the subtrees put back are not traversed
+                return cut.Simplify(level).Replace(e => e is Variable v && back.TryGetValue(v, out var subtree) ? subtree : e);
+            }
+
+            private static void CollectNames(Entity expr, int depth, HashSet<string> names)
+            {
+                if (expr is Variable variable)
+                    names.Add(variable.Name);
+                else if (depth > 0)
+                    foreach (var child in expr.DirectChildren)
+                        CollectNames(child, depth - 1, names);
+            }
+
+            private static Entity Cut(Entity expr, int depth, Dictionary<Entity, Variable> holes, HashSet<string> names)
+            {
+                if (expr.DirectChildren.Count == 0)
+                    return expr;
+                if (depth > 0 && WithChildren(expr, expr.DirectChildren.Select(child => Cut(child, depth - 1, holes, names)).ToArray()) is { } rebuilt)
+                    return rebuilt;
+                if (!holes.TryGetValue(expr, out var hole))
+                {
+                    var index = holes.Count + 1;
+                    while (names.Contains("hole_" + index))
+                        index++;
+                    hole = MathS.Var("hole_" + index);
+                    names.Add(hole.Name);
+                    holes[expr] = hole;
+                }
+                return hole;
+            }
+
+            /// <summary>
+            /// The same node over other children, or null if the node has fields other than
+            /// its children and cannot be rebuilt from them
+            /// </summary>
+            private static Entity? WithChildren(Entity expr, IReadOnlyList<Entity> c)
+                => expr switch
+                {
+                    Sumf => new Sumf(c[0], c[1]),
+                    Minusf => new Minusf(c[0], c[1]),
+                    Mulf => new Mulf(c[0], c[1]),
+                    Divf => new Divf(c[0], c[1]),
+                    Powf => new Powf(c[0], c[1]),
+                    Logf => new Logf(c[0], c[1]),
+                    Sinf => new Sinf(c[0]),
+                    Cosf => new Cosf(c[0]),
+                    Tanf => new Tanf(c[0]),
+                    Cotanf => new Cotanf(c[0]),
+                    Secantf => new Secantf(c[0]),
+                    Cosecantf => new Cosecantf(c[0]),
+                    Arcsinf => new Arcsinf(c[0]),
+                    Arccosf => new Arccosf(c[0]),
+                    Arctanf => new Arctanf(c[0]),
+                    Arccotanf => new Arccotanf(c[0]),
+                    Arcsecantf => new Arcsecantf(c[0]),
+                    Arccosecantf => new Arccosecantf(c[0]),
+                    Factorialf => new Factorialf(c[0]),
+                    Absf => new Absf(c[0]),
+                    Signumf => new Signumf(c[0]),
+                    Phif => new Phif(c[0]),
+                    Notf => new Notf(c[0]),
+                    Andf => new Andf(c[0], c[1]),
+                    Orf => new Orf(c[0], c[1]),
+                    Xorf => new Xorf(c[0], c[1]),
+                    Impliesf => new Impliesf(c[0], c[1]),
+                    Equalsf => new Equalsf(c[0], c[1]),
+                    Greaterf => new Greaterf(c[0], c[1]),
+                    GreaterOrEqualf => new GreaterOrEqualf(c[0], c[1]),
+                    Lessf => new Lessf(c[0], c[1]),
+                    LessOrEqualf => new LessOrEqualf(c[0], c[1]),
+                    _ => null
+                };
+        }
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Collections.Generic;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Flattens a boolean formula over boolean variables into a program of <see cref="NativeInstruction"/>s
+        /// which the C++ side evaluates on many assignments at once, one per bit. Constants are
+        /// <see cref="NativeOpCode.Constant"/> with <see cref="NativeInstruction.Real"/> of 1 or 0.
+        /// </summary>
+        internal sealed class NativeBooleanCompiler
+        {
+            private readonly List<NativeInstruction> instructions = new();
+            private readonly Dictionary<Entity, int> slots = new();
+            private readonly Dictionary<Variable, int> varNamespace = new();
+
+            private NativeBooleanCompiler(IReadOnlyList<Entity> vars)
+            {
+                for (int i = 0; i < vars.Count; i++)
+                    varNamespace[(Variable)vars[i]] = i;
+            }
+
+            internal static NativeInstruction[] Compile(Entity formula, IReadOnlyList<Entity> vars)
+            {
+                var compiler = new NativeBooleanCompiler(vars);
+                var slot = compiler.Emit(formula);
+                compiler.instructions.Add(new() { OpCode = NativeOpCode.Output, First = slot, Second = 0 });
+                return compiler.instructions.ToArray();
+            }
+
+            private int Emit(Entity expr)
+            {
+                if (slots.TryGetValue(expr, out var slot))
+                    return slot;
+                var instruction = expr switch
+                {
+                    Boolean(var value) => new NativeInstruction { OpCode = NativeOpCode.Constant, Real = value ? 1 : 0 },
+                    Variable variable => varNamespace.TryGetValue(variable, out var id)
+                        ? new NativeInstruction { OpCode = NativeOpCode.Variable, First = id }
+                        : throw new NativeCompilationException($"Variable {variable} is not in the list of compiled variables"),
+
+                    Notf(var arg) => new NativeInstruction { OpCode = NativeOpCode.Not, First = Emit(arg) },
+                    Andf(var left, var right) => Binary(NativeOpCode.And, left, right),
+                    Orf(var left, var right) => Binary(NativeOpCode.Or, left, right),
+                    Xorf(var left, var right) => Binary(NativeOpCode.Xor, left, right),
+                    Impliesf(var assumption, var conclusion) => Binary(NativeOpCode.Implies, assumption, conclusion),
+
+                    _ => throw new NativeCompilationException($"The node of type {expr.GetType()} is not a boolean operator")
+                };
+                slot = instructions.Count;
+                instructions.Add(instruction);
+                slots[expr] = slot;
+                return slot;
+            }
+
+            private NativeInstruction Binary(NativeOpCode opCode, Entity left, Entity right)
+            {
+                var first = Emit(left);
+                var second = Emit(right);
+                return new() { OpCode = opCode, First = first, Second = second };
+            }
+        }
+    }
+}
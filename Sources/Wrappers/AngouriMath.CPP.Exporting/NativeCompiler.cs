@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Collections.Generic;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Flattens one or more expressions into a single program of <see cref="NativeInstruction"/>s
+        /// evaluated by the C++ side. Structurally equal subtrees are hash-consed into one slot
+        /// across all the outputs, so shared work is computed once per point.
+        /// </summary>
+        internal sealed class NativeCompiler
+        {
+            private readonly List<NativeInstruction> instructions = new();
+            private readonly Dictionary<Entity, int> slots = new();
+            private readonly Dictionary<Variable, int> varNamespace = new();
+
+            private NativeCompiler(IReadOnlyList<Entity> vars)
+            {
+                for (int i = 0; i < vars.Count; i++)
+                    varNamespace[(Variable)vars[i]] = i;
+            }
+
+            internal static NativeInstruction[] Compile(IReadOnlyList<Entity> outputs, IReadOnlyList<Entity> vars)
+            {
+                var compiler = new NativeCompiler(vars);
+                var outputSlots = new int[outputs.Count];
+                for (int i = 0; i < outputs.Count; i++)
+                    outputSlots[i] = compiler.Emit(outputs[i]);
+                for (int i = 0; i < outputs.Count; i++)
+                    compiler.instructions.Add(new() { OpCode = NativeOpCode.Output, First = outputSlots[i], Second = i });
+                return compiler.instructions.ToArray();
+            }
+
+            private int Emit(Entity expr)
+            {
+                if (slots.TryGetValue(expr, out var slot))
+                    return slot;
+                var instruction = expr switch
+                {
+                    Variable { IsConstant: true } constant => Constant((Number.Complex)constant.Evaled),
+                    Variable variable => varNamespace.TryGetValue(variable, out var id)
+                        ? new NativeInstruction { OpCode = NativeOpCode.Variable, First = id }
+                        : throw new NativeCompilationException($"Variable {variable} is not in the list of compiled variables"),
+                    Number.Complex number => Constant(number),
+
+                    Sumf(var augend, var addend) => Binary(NativeOpCode.Sum, augend, addend),
+                    Minusf(var subtrahend, var minuend) => Binary(NativeOpCode.Minus, subtrahend, minuend),
+                    Mulf(var multiplier, var multiplicand) => Binary(NativeOpCode.Mul, multiplier, multiplicand),
+                    Divf(var dividend, var divisor) => Binary(NativeOpCode.Div, dividend, divisor),
+                    Powf(var @base, var exponent) => Binary(NativeOpCode.Pow, @base, exponent),
+                    Logf(var @base, var antilogarithm) => Binary(NativeOpCode.Log, @base, antilogarithm),
+
+                    Sinf(var arg) => Unary(NativeOpCode.Sin, arg),
+                    Cosf(var arg) => Unary(NativeOpCode.Cos, arg),
+                    Secantf(var arg) => Unary(NativeOpCode.Secant, arg),
+                    Cosecantf(var arg) => Unary(NativeOpCode.Cosecant, arg),
+                    Tanf(var arg) => Unary(NativeOpCode.Tan, arg),
+                    Cotanf(var arg) => Unary(NativeOpCode.Cotan, arg),
+                    Arcsinf(var arg) => Unary(NativeOpCode.Arcsin, arg),
+                    Arccosf(var arg) => Unary(NativeOpCode.Arccos, arg),
+                    Arctanf(var arg) => Unary(NativeOpCode.Arctan, arg),
+                    Arccotanf(var arg) => Unary(NativeOpCode.Arccotan, arg),
+                    Arcsecantf(var arg) => Unary(NativeOpCode.Arcsecant, arg),
+                    Arccosecantf(var arg) => Unary(NativeOpCode.Arccosecant, arg),
+                    Factorialf(var arg) => Unary(NativeOpCode.Factorial, arg),
+                    Signumf(var arg) => Unary(NativeOpCode.Signum, arg),
+                    Absf(var arg) => Unary(NativeOpCode.Abs, arg),
+                    Phif(var arg) => Unary(NativeOpCode.Phi, arg),
+
+                    _ => throw new NativeCompilationException($"The node of type {expr.GetType()} cannot be compiled natively")
+                };
+                slot = instructions.Count;
+                instructions.Add(instruction);
+                slots[expr] = slot;
+                return slot;
+            }
+
+            private static NativeInstruction Constant(Number.Complex value)
+                => new() { OpCode = NativeOpCode.Constant, Real = (double)value.RealPart, Imaginary = (double)value.ImaginaryPart };
+
+            // children are emitted first, so they always get smaller slots than their parent
+            private NativeInstruction Unary(NativeOpCode opCode, Entity arg)
+                => new() { OpCode = opCode, First = Emit(arg) };
+
+            private NativeInstruction Binary(NativeOpCode opCode, Entity left, Entity right)
+            {
+                var first = Emit(left);
+                var second = Emit(right);
+                return new() { OpCode = opCode, First = first, Second = second };
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Collections.Generic;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Flattens an expression of rational operations into a program of <see cref="NativeInstruction"/>s
+        /// which the C++ side evaluates exactly in 64-bit integers. Constants are kept apart as
+        /// (numerator, denominator) pairs, <see cref="NativeInstruction.First"/> of a
+        /// <see cref="NativeOpCode.Constant"/> is the index of its pair.
+        /// </summary>
+        internal sealed class NativeRationalCompiler
+        {
+            private readonly List<NativeInstruction> instructions = new();
+            private readonly List<(long, long)> constants = new();
+            private readonly Dictionary<Entity, int> slots = new();
+            private readonly Dictionary<Variable, int> varNamespace = new();
+
+            private NativeRationalCompiler(IReadOnlyList<Entity> vars)
+            {
+                for (int i = 0; i < vars.Count; i++)
+                    varNamespace[(Variable)vars[i]] = i;
+            }
+
+            internal static (NativeInstruction[] Instructions, (long, long)[] Constants) Compile(Entity expr, IReadOnlyList<Entity> vars)
+            {
+                var compiler = new NativeRationalCompiler(vars);
+                var slot = compiler.Emit(expr);
+                compiler.instructions.Add(new() { OpCode = NativeOpCode.Output, First = slot, Second = 0 });
+                return (compiler.instructions.ToArray(), compiler.constants.ToArray());
+            }
+
+            private int Emit(Entity expr)
+            {
+                if (slots.TryGetValue(expr, out var slot))
+                    return slot;
+                var instruction = expr switch
+                {
+                    Number.Rational rational => Constant(rational),
+                    Variable { IsConstant: true } constant
+                        => throw new NativeCompilationException($"The constant {constant} is not rational"),
+                    Variable variable => varNamespace.TryGetValue(variable, out var id)
+                        ? new NativeInstruction { OpCode = NativeOpCode.Variable, First = id }
+                        : throw new NativeCompilationException($"Variable {variable} is not in the list of compiled variables"),
+
+                    Sumf(var augend, var addend) => Binary(NativeOpCode.Sum, augend, addend),
+                    Minusf(var subtrahend, var minuend) => Binary(NativeOpCode.Minus, subtrahend, minuend),
+                    Mulf(var multiplier, var multiplicand) => Binary(NativeOpCode.Mul, multiplier, multiplicand),
+                    Divf(var dividend, var divisor) => Binary(NativeOpCode.Div, dividend, divisor),
+                    Powf(var @base, var exponent) => Binary(NativeOpCode.Pow, @base, exponent),
+                    Absf(var arg) => new NativeInstruction { OpCode = NativeOpCode.Abs, First = Emit(arg) },
+                    Signumf(var arg) => new NativeInstruction { OpCode = NativeOpCode.Signum, First = Emit(arg) },
+                    Factorialf(var arg) => new NativeInstruction { OpCode = NativeOpCode.Factorial, First = Emit(arg) },
+
+                    _ => throw new NativeCompilationException($"The node of type {expr.GetType()} cannot be evaluated exactly")
+                };
+                slot = instructions.Count;
+                instructions.Add(instruction);
+                slots[expr] = slot;
+                return slot;
+            }
+
+            private NativeInstruction Constant(Number.Rational value)
+            {
+                var (numerator, denominator) = (value.ERational.Numerator, value.ERational.Denominator);
+                // the native arithmetic never produces long.MinValue, so its negation is always defined
+                if (!numerator.CanFitInInt64() || !denominator.CanFitInInt64() || numerator.ToInt64Checked() == long.MinValue)
+                    throw new NativeCompilationException($"The constant {value} does not fit into 64 bits");
+                constants.Add((numerator.ToInt64Checked(), denominator.ToInt64Checked()));
+                return new() { OpCode = NativeOpCode.Constant, First = constants.Count - 1 };
+            }
+
+            private NativeInstruction Binary(NativeOpCode opCode, Entity left, Entity right)
+            {
+                var first = Emit(left);
+                var second = Emit(right);
+                return new() { OpCode = opCode, First = first, Second = second };
+            }
+        }
+    }
+}
@@ -26,6 +26,14 @@ namespace AngouriMath.CPP.Exporting
                 ObjStorage<GCHandle>.Alloc(new((ulong)ptr), allocated);
                 return new() { Length = arr.Length, Ptr = ptr };
             }
+            internal unsafe Entity[] AsEntities()
+            {
+                var refs = (ObjRef*)Ptr;
+                var res = new Entity[Length];
+                for (int i = 0; i < Length; i++)
+                    res[i] = refs[i].AsEntity;
+                return res;
+            }
             public void Free()
             {
                 var handle = ObjStorage<GCHandle>.Get(new((ulong)Ptr));
@@ -18,6 +18,8 @@ namespace AngouriMath.CPP.Exporting
             public static NativeBool False => new(false);
             public static implicit operator NativeBool(bool value)
                 => new(value);
+            public static implicit operator bool(NativeBool value)
+                => value.value != 0;
         }
     }
 }
@@ -0,0 +1,38 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Pinned array of blittable values (as opposed to <see cref="NativeArray"/>,
+        /// which only transfers handles)
+        /// </summary>
+        public struct NativeBuffer : IFreeable
+        {
+            public int Length { get; init; }
+            public IntPtr Ptr { get; init; }
+            internal static NativeBuffer Alloc<T>(T[] elements) where T : unmanaged
+            {
+                var allocated = GCHandle.Alloc(elements, GCHandleType.Pinned);
+                var ptr = allocated.AddrOfPinnedObject();
+                ObjStorage<GCHandle>.Alloc(new((ulong)ptr), allocated);
+                return new() { Length = elements.Length, Ptr = ptr };
+            }
+            public void Free()
+            {
+                var handle = ObjStorage<GCHandle>.Get(new((ulong)Ptr));
+                handle.Free();
+                ObjStorage<GCHandle>.Dealloc(new((ulong)Ptr));
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// State of the garbage collector of the runtime, kept in sync with
+        /// AngouriMath::Internal::NativeGcInfo. Durations are in nanoseconds.
+        /// </summary>
+        public struct NativeGcInfo
+        {
+            public NativeBool IsServer;
+            public NativeBool IsConcurrent;
+            public int LatencyMode;
+            public int ConserveMemory;
+            public long HeapHardLimitBytes;
+            public long HeapSizeBytes;
+            public long CommittedBytes;
+            public long FragmentedBytes;
+            public long TotalAllocatedBytes;
+            public long Gen0Collections;
+            public long Gen1Collections;
+            public long Gen2Collections;
+            public long TotalPauseNanoseconds;
+            public long LastPauseNanoseconds;
+            public double PauseTimePercentage;
+        }
+    }
+}
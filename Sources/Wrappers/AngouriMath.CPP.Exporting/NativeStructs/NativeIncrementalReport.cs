@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// How many subtrees an incremental simplification simplified and how many it took
+        /// from the results of earlier calls
+        /// </summary>
+        public struct NativeIncrementalReport
+        {
+            public int Simplified;
+            public int Reused;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Kept in sync with AngouriMath::OpCode in CompiledFunction.h. The numbering
+        /// follows the instruction types of <see cref="AngouriMath.Core.FastExpression"/>.
+        /// </summary>
+        public enum NativeOpCode
+        {
+            Variable,
+            Constant,
+            Output,
+
+            // 1-arg functions
+            Sin = 50,
+            Cos,
+            Secant,
+            Cosecant,
+            Tan,
+            Cotan,
+            Arcsin,
+            Arccos,
+            Arctan,
+            Arccotan,
+            Arcsecant,
+            Arccosecant,
+            Factorial,
+            Signum,
+            Abs,
+            Phi,
+
+            // 2-arg functions
+            Sum = 100,
+            Minus,
+            Mul,
+            Div,
+            Pow,
+            Log,
+
+            // Boolean programs only, see NativeBooleanCompiler
+            Not = 150,
+            And = 200,
+            Or,
+            Xor,
+            Implies,
+        }
+
+        /// <summary>
+        /// One step of a natively evaluated program. The i-th instruction computes the i-th slot,
+        /// <see cref="First"/> and <see cref="Second"/> refer to previously computed slots
+        /// (or to the variable index for <see cref="NativeOpCode.Variable"/> and to the slot
+        /// and output index for <see cref="NativeOpCode.Output"/>).
+        /// </summary>
+        public struct NativeInstruction
+        {
+            public NativeOpCode OpCode;
+            public int First;
+            public int Second;
+            public double Real;
+            public double Imaginary;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// One step of the postfix program built by the native parser, <see cref="Start"/>
+        /// and <see cref="Length"/> locate the text of numbers, variables and function names
+        /// in the source
+        /// </summary>
+        public struct NativeParseNode
+        {
+            public ParseNodeKind Kind;
+            public int Start;
+            public int Length;
+            public int Arity;
+        }
+
+        public enum ParseNodeKind
+        {
+            Number,
+            Variable,
+            Sum,
+            Minus,
+            Mul,
+            Div,
+            Pow,
+            NegateOperand,
+            Negate,
+            Factorial,
+            Function,
+        }
+    }
+}
@@ -0,0 +1,27 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// A non-zero coefficient of a polynomial. <see cref="Numerator"/> and
+        /// <see cref="Denominator"/> are only meaningful if <see cref="IsRational"/> is set,
+        /// that is, the coefficient is a rational which fits into 64 bits.
+        /// </summary>
+        public struct NativePolynomialTerm
+        {
+            public long Power;
+            public double Real;
+            public double Imaginary;
+            public long Numerator;
+            public long Denominator;
+            public NativeBool IsRational;
+        }
+    }
+}
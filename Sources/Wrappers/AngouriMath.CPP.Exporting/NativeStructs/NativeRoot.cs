@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Kept in sync with AngouriMath::RootKind in AngouriMath.h
+        /// </summary>
+        public enum NativeRootKind
+        {
+            Exact,
+            Newton,
+            NonFinite,
+            Symbolic,
+        }
+
+        /// <summary>
+        /// One numerical root of an equation. Non-finite and symbolic roots
+        /// are NaN, their <see cref="Kind"/> tells why.
+        /// </summary>
+        public struct NativeRoot
+        {
+            public double Real;
+            public double Imaginary;
+            public NativeRootKind Kind;
+        }
+    }
+}
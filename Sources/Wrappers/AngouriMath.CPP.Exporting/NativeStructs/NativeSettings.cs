@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Values of <see cref="MathS.Settings"/>, kept in sync with
+        /// AngouriMath::Internal::NativeSettings. When overriding, only the
+        /// settings in <see cref="Mask"/> are applied.
+        /// </summary>
+        public struct NativeSettings
+        {
+            public NativeSettingsMask Mask;
+            public int FloatToRationalIterCount;
+            public long MaxAbsNumeratorOrDenominatorValue;
+            public double PrecisionErrorCommon;
+            public double PrecisionErrorZeroRange;
+            public NativeBool AllowNewton;
+            public NativeBool DowncastingEnabled;
+            public NativeBool ExplicitParsingOnly;
+            public int NewtonPrecision;
+            public long MaxExpansionTermCount;
+            public double NewtonFromRe;
+            public double NewtonFromIm;
+            public double NewtonToRe;
+            public double NewtonToIm;
+            public int NewtonStepsRe;
+            public int NewtonStepsIm;
+        }
+
+        [Flags]
+        public enum NativeSettingsMask
+        {
+            None = 0,
+            PrecisionErrorCommon = 1 << 0,
+            PrecisionErrorZeroRange = 1 << 1,
+            FloatToRationalIterCount = 1 << 2,
+            MaxAbsNumeratorOrDenominatorValue = 1 << 3,
+            AllowNewton = 1 << 4,
+            NewtonSolver = 1 << 5,
+            DowncastingEnabled = 1 << 6,
+            ExplicitParsingOnly = 1 << 7,
+            MaxExpansionTermCount = 1 << 8,
+            All = (1 << 9) - 1,
+        }
+    }
+}
@@ -0,0 +1,21 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// What a budgeted simplification did, the timing is measured by the caller
+        /// </summary>
+        public struct NativeSimplifyReport
+        {
+            public int AlternativesExplored;
+            public NativeBool BudgetExceeded;
+        }
+    }
+}
@@ -34,6 +34,7 @@ namespace AngouriMath.CPP.Exporting
             }
             internal static T Get(ObjRef ptr)
             {
+                using var _ = new TraceSpan("ObjStorage.Get");
                 if (!allocations.ContainsKey(ptr))
                     throw new NonExistentObjectAddressingException();
                 return allocations[ptr];
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System;
+using System.Collections.Generic;
+using static AngouriMath.Entity;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Builds the expression from the program of the native parser. Every step applies
+        /// the same action as the rule of the grammar it was parsed by, so the result is
+        /// the same tree <see cref="MathS.FromString(string)"/> gives.
+        /// </summary>
+        internal static class ParsedExpressionBuilder
+        {
+            // names are few, so variables are reused rather than created for every occurrence
+            private static readonly Dictionary<string, Variable> variables = new();
+            private const int MaxCachedVariables = 1 << 12;
+
+            internal static Entity Build(string source, ReadOnlySpan<NativeParseNode> program)
+            {
+                var stack = new Stack<Entity>();
+                foreach (var node in program)
+                {
+                    switch (node.Kind)
+                    {
+                        case ParseNodeKind.Number:
+                            stack.Push(Number.Complex.Parse(source.Substring(node.Start, node.Length)));
+                            break;
+                        case ParseNodeKind.Variable:
+                            stack.Push(Var(source.Substring(node.Start, node.Length)));
+                            break;
+                        case ParseNodeKind.NegateOperand:
+                        {
+                            var operand = stack.Pop();
+                            stack.Push(operand is Number num ? -num : -operand);
+                            break;
+                        }
+                        case ParseNodeKind.Negate:
+                            stack.Push(-stack.Pop());
+                            break;
+                        case ParseNodeKind.Factorial:
+                            stack.Push(MathS.Factorial(stack.Pop()));
+                            break;
+                        case ParseNodeKind.Function:
+                        {
+                            var args = new Entity[node.Arity];
+                            for (int i = args.Length - 1; i >= 0; i--)
+                                args[i] = stack.Pop();
+                            stack.Push(Function(source.Substring(node.Start, node.Length), args));
+                            break;
+                        }
+                        default:
+                        {
+                            var right = stack.Pop();
+                            var left = stack.Pop();
+                            stack.Push(node.Kind switch
+                            {
+                                ParseNodeKind.Sum => left + right,
+                                ParseNodeKind.Minus => left - right,
+                                ParseNodeKind.Mul => left * right,
+                                ParseNodeKind.Div => left / right,
+                                ParseNodeKind.Pow => left.Pow(right),
+                                _ => throw new ArgumentOutOfRangeException(nameof(program), $"Unknown parse node {node.Kind}")
+                            });
+                            break;
+                        }
+                    }
+                }
+                if (stack.Count != 1)
+                    throw new ArgumentException("The parsed program does not build exactly one expression", nameof(program));
+                return stack.Pop();
+            }
+
+            private static Variable Var(string name)
+            {
+                lock (variables)
+                {
+                    if (variables.TryGetValue(name, out var known))
+                        return known;
+                    if (variables.Count >= MaxCachedVariables)
+                        variables.Clear();
+                    var res = MathS.Var(name);
+                    variables.Add(name, res);
+                    return res;
+                }
+            }
+
+            private static Entity Function(string name, Entity[] args) => name switch
+            {
+                "log" => args.Length == 1 ? MathS.Log(10, args[0]) : MathS.Log(args[0], args[1]),
+                "sqrt" => MathS.Sqrt(args[0]),
+                "cbrt" => MathS.Cbrt(args[0]),
+                "sqr" => MathS.Sqr(args[0]),
+                "ln" => MathS.Ln(args[0]),
+                "sin" => MathS.Sin(args[0]),
+                "cos" => MathS.Cos(args[0]),
+                "tan" => MathS.Tan(args[0]),
+                "cotan" or "cot" => MathS.Cotan(args[0]),
+                "sec" => MathS.Sec(args[0]),
+                "cosec" or "csc" => MathS.Cosec(args[0]),
+                "arcsin" or "asin" => MathS.Arcsin(args[0]),
+                "arccos" or "acos" => MathS.Arccos(args[0]),
+                "arctan" or "atan" => MathS.Arctan(args[0]),
+                "arccotan" or "acotan" or "acot" or "arccot" => MathS.Arccotan(args[0]),
+                "arcsec" or "asec" => MathS.Arcsec(args[0]),
+                "arccosec" or "arccsc" or "acsc" or "acosec" => MathS.Arccosec(args[0]),
+                "sinh" or "sh" => MathS.Hyperbolic.Sinh(args[0]),
+                "cosh" or "ch" => MathS.Hyperbolic.Cosh(args[0]),
+                "tanh" or "th" => MathS.Hyperbolic.Tanh(args[0]),
+                "cotanh" or "coth" or "cth" => MathS.Hyperbolic.Cotanh(args[0]),
+                "sech" or "sch" => MathS.Hyperbolic.Sech(args[0]),
+                "cosech" or "csch" => MathS.Hyperbolic.Cosech(args[0]),
+                "asinh" or "arsinh" or "arsh" => MathS.Hyperbolic.Arsinh(args[0]),
+                "acosh" or "arcosh" or "arch" => MathS.Hyperbolic.Arcosh(args[0]),
+                "atanh" or "artanh" or "arth" => MathS.Hyperbolic.Artanh(args[0]),
+                "acoth" or "arcoth" or "acotanh" or "arcotanh" or "arcth" => MathS.Hyperbolic.Arcotanh(args[0]),
+                "asech" or "arsech" or "arsch" => MathS.Hyperbolic.Arsech(args[0]),
+                "acosech" or "arcosech" or "arcsch" or "acsch" => MathS.Hyperbolic.Arcosech(args[0]),
+                "gamma" => MathS.Gamma(args[0]),
+                "signum" or "sgn" or "sign" => MathS.Signum(args[0]),
+                "abs" => MathS.Abs(args[0]),
+                "phi" => MathS.NumberTheory.Phi(args[0]),
+                _ => throw new ArgumentException($"Unknown function {name}", nameof(name))
+            };
+        }
+    }
+}
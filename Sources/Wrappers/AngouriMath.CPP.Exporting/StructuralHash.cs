@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2019-2022 Angouri.
+// AngouriMath is licensed under MIT.
+// Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+// Website: https://am.angouri.org.
+//
+
+using System.Runtime.CompilerServices;
+
+namespace AngouriMath.CPP.Exporting
+{
+    partial class Exports
+    {
+        /// <summary>
+        /// Structural hash of an expression which, unlike <see cref="object.GetHashCode"/>,
+        /// does not depend on the process (string hashes are randomized in .NET), so it can
+        /// be stored on disk or shared between processes. Structurally equal expressions
+        /// have equal hashes; the converse does not hold, so equality must still be checked.
+        /// </summary>
+        internal static class StructuralHash
+        {
+            internal const ulong OffsetBasis = 14695981039346656037;
+            private const ulong Prime = 1099511628211;
+
+            // subtrees are often shared between expressions (e. g. after a substitution),
+            // so their hashes are remembered for as long as the subtree is alive
+            private static readonly ConditionalWeakTable<Entity, StrongBox<ulong>> cache = new();
+
+            internal static ulong Of(Entity expr)
+            {
+                if (cache.TryGetValue(expr, out var cached))
+                    return cached.Value;
+                var hash = Combine(OffsetBasis, expr.GetType().Name);
+                if (expr.DirectChildren.Count == 0)
+                    hash = Combine(hash, expr.ToString());
+                else
+                    foreach (var child in expr.DirectChildren)
+                        hash = Combine(hash, Of(child));
+                cache.AddOrUpdate(expr, new(hash));
+                return hash;
+            }
+
+            internal static ulong Combine(ulong hash, string value)
+            {
+                foreach (var c in value)
+                    hash = (hash ^ c) * Prime;
+                return hash;
+            }
+
+            internal static ulong Combine(ulong hash, ulong value)
+            {
+                for (int i = 0; i < 8; i++)
+                {
+                    hash = (hash ^ (value & 0xFF)) * Prime;
+                    value >>= 8;
+                }
+                return hash;
+            }
+        }
+    }
+}
@@ -7,8 +7,12 @@
 
 #include "AngouriMath.h"
 #include "Imports.h"
+#include "Parser.h"
 #include <vector>
 #include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
 
 namespace AngouriMath
 {
@@ -33,12 +37,60 @@ namespace AngouriMath
                 return res;
             };
         }
+
+        std::vector<Internal::EntityRef> GetHandles(const std::vector<Entity>& entities)
+        {
+            std::vector<Internal::EntityRef> res(entities.size());
+            for (size_t i = 0; i < entities.size(); i++)
+                res[i] = GetHandle(entities[i]);
+            return res;
+        }
+
+        // takes ownership of the buffer
+        std::vector<Instruction> ToInstructions(NativeBuffer nInstructions)
+        {
+            auto data = static_cast<const NativeInstruction*>(nInstructions.data);
+            std::vector<Instruction> instructions(nInstructions.length);
+            for (size_t i = 0; i < instructions.size(); i++)
+            {
+                const auto& ins = data[i];
+                instructions[i] = Instruction{ (OpCode)ins.opCode, ins.first, ins.second, { ins.real, ins.imaginary } };
+            }
+            (void)free_native_buffer(nInstructions);
+            return instructions;
+        }
+
+        // takes ownership of the buffer
+        CompiledFunction ToCompiledFunction(NativeBuffer nInstructions, size_t varCount)
+        {
+            return CompiledFunction(ToInstructions(nInstructions), varCount);
+        }
+
+        std::int32_t CheckedCount(size_t count, const char* what)
+        {
+            if (count > (size_t)std::numeric_limits<std::int32_t>::max())
+                throw AngouriMathException(ErrorCode("System.ArgumentOutOfRangeException",
+                    std::string(what) + " " + std::to_string(count) + " exceeds " + std::to_string(std::numeric_limits<std::int32_t>::max()), ""));
+            return (std::int32_t)count;
+        }
+
+        // the imaginary part is dropped, non-real results are reported as errors
+        void ComplexToReal(const std::complex<double>* values, size_t count, double* out, std::uint8_t* errors)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                out[i] = values[i].real();
+                if (values[i].imag() != 0.0)
+                    errors[i] = 1;
+            }
+        }
     }
 
     struct HandleDeleter
     {
         void operator()(const Internal::EntityInstance* inner)
         {
+            TraceSpan span("Entity::~Entity");
             if (inner != nullptr)
             {
                 (void)free_entity(inner->GetReference());
@@ -56,14 +108,45 @@ namespace AngouriMath
         #endif
     }
 
+    namespace Internal
+    {
+        bool TryParseNative(const char* expr, EntityRef& result)
+        {
+            thread_local std::vector<NativeParseNode> program;
+            bool implicitOperators = false;
+            if (!ParseNative(expr, program, implicitOperators))
+                return false;
+            NativeBuffer nProgram{ CheckedCount(program.size(), "Parsed node count"), program.data() };
+            HandleErrorCode(maths_build_parsed(expr, nProgram, implicitOperators, &result));
+            return true;
+        }
+    }
+
     Internal::EntityRef ParseString(const char* expr)
     {
+        TraceSpan span("Entity::Entity(string)");
         assert(expr != nullptr);
         Internal::EntityRef result;
-        HandleErrorCode(maths_from_string(expr, &result));
+        if (!Internal::TryParseNative(expr, result))
+            HandleErrorCode(maths_from_string(expr, &result));
         return result;
     }
 
+    std::optional<Entity> ParseNative(const std::string& expr)
+    {
+        Internal::EntityRef result;
+        if (!Internal::TryParseNative(expr.c_str(), result))
+            return std::nullopt;
+        return CreateByHandle(result);
+    }
+
+    Entity ParseManaged(const std::string& expr)
+    {
+        Internal::EntityRef result;
+        HandleErrorCode(maths_from_string(expr.c_str(), &result));
+        return CreateByHandle(result);
+    }
+
     Entity::Entity()
         : innerEntityInstance(nullptr, HandleDeleter())
     {
@@ -86,6 +169,7 @@ namespace AngouriMath
 
     std::string Entity::Latexise() const
     {
+        TraceSpan span("Entity::Latexise");
         char* buff = nullptr;
         HandleErrorCode(entity_latexise(innerEntityInstance.get()->GetReference(), &buff));
         auto res = buff != nullptr ? std::string(buff) : std::string();
@@ -96,6 +180,7 @@ namespace AngouriMath
 
     Entity Entity::Differentiate(const Entity& var) const
     {
+        TraceSpan span("Entity::Differentiate");
         Internal::EntityRef result;
         HandleErrorCode(entity_differentiate(innerEntityInstance.get()->GetReference(), var.innerEntityInstance.get()->GetReference(), &result));
         return Entity(result);
@@ -103,6 +188,7 @@ namespace AngouriMath
 
     Entity Entity::Integrate(const Entity& var) const
     {
+        TraceSpan span("Entity::Integrate");
         Internal::EntityRef result;
         HandleErrorCode(entity_integrate(innerEntityInstance.get()->GetReference(), var.innerEntityInstance.get()->GetReference(), &result));
         return Entity(result);
@@ -110,6 +196,7 @@ namespace AngouriMath
 
     Entity Entity::Solve(const Entity& var) const
     {
+        TraceSpan span("Entity::Solve");
         Internal::EntityRef result;
         HandleErrorCode(entity_solve(innerEntityInstance.get()->GetReference(), var.innerEntityInstance.get()->GetReference(), &result));
         return Entity(result);
@@ -117,14 +204,44 @@ namespace AngouriMath
 
     Entity Entity::SolveEquation(const Entity& var) const
     {
+        TraceSpan span("Entity::SolveEquation");
         Internal::EntityRef result;
         HandleErrorCode(entity_solve_equation(innerEntityInstance.get()->GetReference(), var.innerEntityInstance.get()->GetReference(), &result));
         return Entity(result);
     }
 
+    NumericRoots Entity::SolveEquationNumeric(const Entity& var) const
+    {
+        return SolveEquationsNumeric({ *this }, var);
+    }
+
+    NumericRoots SolveEquationsNumeric(const std::vector<Entity>& equations, const Entity& var)
+    {
+        auto handles = Internal::GetHandles(equations);
+        Internal::NativeArray nEquations{ Internal::CheckedCount(handles.size(), "Equation count"), handles.data() };
+        Internal::NativeBuffer nRoots, nOffsets;
+        HandleErrorCode(entity_solve_equations_numeric(nEquations, GetHandle(var), &nRoots, &nOffsets));
+
+        NumericRoots res;
+        auto roots = static_cast<const Internal::NativeRoot*>(nRoots.data);
+        res.values.resize(nRoots.length);
+        res.kinds.resize(nRoots.length);
+        for (size_t i = 0; i < res.values.size(); i++)
+        {
+            res.values[i] = { roots[i].real, roots[i].imaginary };
+            res.kinds[i] = (RootKind)roots[i].kind;
+        }
+        auto offsets = static_cast<const std::int32_t*>(nOffsets.data);
+        res.offsets.assign(offsets, offsets + nOffsets.length);
+        (void)free_native_buffer(nRoots);
+        (void)free_native_buffer(nOffsets);
+        return res;
+    }
+
 
     Entity Entity::Limit(const Entity& var, const Entity& dest, ApproachFrom from) const
     {
+        TraceSpan span("Entity::Limit");
         Internal::EntityRef result;
         HandleErrorCode(
             entity_limit(
@@ -145,17 +262,488 @@ namespace AngouriMath
 
     Entity Entity::Simplify() const
     {
+        TraceSpan span("Entity::Simplify");
+        if (!Internal::IsSimplificationCacheEnabled())
+        {
+            Internal::EntityRef res;
+            HandleErrorCode(entity_simplify(innerEntityInstance.get()->GetReference(), &res));
+            return Entity(res);
+        }
+
+        std::uint64_t settings;
+        HandleErrorCode(settings_fingerprint(&settings));
+        const auto key = StructuralHash() ^ (settings * 0x9E3779B97F4A7C15ull);
+        const auto& input = ToString();
+        if (auto cached = Internal::SimplificationCacheLookup(key, input))
+            return Entity(*cached);
+        Internal::EntityRef ref;
+        HandleErrorCode(entity_simplify(innerEntityInstance.get()->GetReference(), &ref));
+        Entity res(ref);
+        // only results which parse back into themselves are stored
+        const auto& output = res.ToString();
+        if (Entity(output) == res)
+            Internal::SimplificationCacheStore(key, input, output);
+        return res;
+    }
+
+    Entity Entity::Simplify(const SimplifyOptions& options, SimplifyReport* report) const
+    {
+        TraceSpan span("Entity::Simplify(SimplifyOptions)");
+        constexpr size_t unbounded = std::numeric_limits<std::int32_t>::max();
+        Internal::NativeSimplifyReport native;
+        Internal::EntityRef res;
+        const auto start = std::chrono::steady_clock::now();
+        HandleErrorCode(entity_simplify_with(
+            innerEntityInstance.get()->GetReference(),
+            options.level,
+            (std::int32_t)std::min(options.maxAlternatives, unbounded),
+            (std::int32_t)std::min(options.maxNodes, unbounded),
+            &native,
+            &res
+        ));
+        if (report != nullptr)
+        {
+            report->alternativesExplored = (size_t)native.alternativesExplored;
+            report->budgetExceeded = native.budgetExceeded != 0;
+            report->elapsed = std::chrono::steady_clock::now() - start;
+        }
+        return Entity(res);
+    }
+
+    Entity Entity::SimplifyIncremental(int level, int window, IncrementalSimplifyReport* report) const
+    {
+        TraceSpan span("Entity::SimplifyIncremental");
+        Internal::NativeIncrementalReport native;
+        Internal::EntityRef res;
+        HandleErrorCode(entity_simplify_incremental(innerEntityInstance.get()->GetReference(), level, window, &native, &res));
+        if (report != nullptr)
+        {
+            report->simplified = (size_t)native.simplified;
+            report->reused = (size_t)native.reused;
+        }
+        return Entity(res);
+    }
+
+    void ClearIncrementalSimplification()
+    {
+        HandleErrorCode(incremental_simplifier_clear());
+    }
+
+    Entity Entity::Substitute(const Entity& x, const Entity& value) const
+    {
+        TraceSpan span("Entity::Substitute");
         Internal::EntityRef res;
-        HandleErrorCode(entity_simplify(innerEntityInstance.get()->GetReference(), &res));
+        HandleErrorCode(entity_substitute(innerEntityInstance.get()->GetReference(), GetHandle(x), GetHandle(value), &res));
+        return Entity(res);
+    }
+
+    Entity Entity::Substitute(const std::vector<Entity>& vars, const std::vector<Entity>& values) const
+    {
+        TraceSpan span("Entity::Substitute(vars)");
+        auto varHandles = Internal::GetHandles(vars);
+        auto valueHandles = Internal::GetHandles(values);
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        Internal::NativeArray nValues{ Internal::CheckedCount(valueHandles.size(), "Value count"), valueHandles.data() };
+        Internal::EntityRef res;
+        HandleErrorCode(entity_substitute_vars(innerEntityInstance.get()->GetReference(), nVars, nValues, &res));
+        return Entity(res);
+    }
+
+    Entity Entity::Replace(const Entity& node, const Entity& replacement) const
+    {
+        TraceSpan span("Entity::Replace");
+        Internal::EntityRef res;
+        HandleErrorCode(entity_replace_node(innerEntityInstance.get()->GetReference(), GetHandle(node), GetHandle(replacement), &res));
         return Entity(res);
     }
 
     std::vector<Entity> Entity::Alternate() const
     {
+        TraceSpan span("Entity::Alternate");
         auto lambda = GetLambdaByArrayFactory(entity_alternate);
         return lambda(innerEntityInstance.get()->GetReference());
     }
 
+    EntityCursor Entity::NodesCursor(size_t maxPageSize) const
+    {
+        Internal::CursorRef res;
+        HandleErrorCode(entity_nodes_cursor(innerEntityInstance.get()->GetReference(), &res));
+        return EntityCursor(res, maxPageSize);
+    }
+
+    EntityCursor Entity::AlternateCursor(size_t maxPageSize) const
+    {
+        Internal::CursorRef res;
+        HandleErrorCode(entity_alternate_cursor(innerEntityInstance.get()->GetReference(), &res));
+        return EntityCursor(res, maxPageSize);
+    }
+
+    EntityCursor::EntityCursor(Internal::CursorRef handle, size_t maxPageSize)
+        : handle(handle), open(true), maxPageSize(std::max<size_t>(maxPageSize, 1))
+    {
+    }
+
+    EntityCursor::EntityCursor(EntityCursor&& other) noexcept
+        : handle(other.handle), open(other.open), nextPageSize(other.nextPageSize), maxPageSize(other.maxPageSize),
+        page(std::move(other.page)), position(other.position)
+    {
+        other.open = false;
+        other.page.clear();
+        other.position = 0;
+    }
+
+    EntityCursor& EntityCursor::operator=(EntityCursor&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            handle = other.handle;
+            open = other.open;
+            nextPageSize = other.nextPageSize;
+            maxPageSize = other.maxPageSize;
+            page = std::move(other.page);
+            position = other.position;
+            other.open = false;
+            other.page.clear();
+            other.position = 0;
+        }
+        return *this;
+    }
+
+    void EntityCursor::Close()
+    {
+        if (open)
+        {
+            open = false;
+            (void)free_cursor(handle);
+        }
+    }
+
+    void EntityCursor::Fill()
+    {
+        if (position < page.size() || !open)
+            return;
+        TraceSpan span("EntityCursor::Fill");
+        Internal::NativeArray nPage;
+        HandleErrorCode(cursor_next_page(handle, (std::int32_t)std::min<size_t>(nextPageSize, std::numeric_limits<std::int32_t>::max()), &nPage));
+        page.resize(nPage.length);
+        for (size_t i = 0; i < page.size(); i++)
+            page[i] = CreateByHandle(nPage.refs[i]);
+        (void)free_native_array(nPage);
+        position = 0;
+        nextPageSize = std::min(nextPageSize * 2, maxPageSize);
+        if (page.empty())
+            Close();
+    }
+
+    void EntityCursor::Advance()
+    {
+        position++;
+        Fill();
+    }
+
+    EntityCursor::iterator EntityCursor::begin()
+    {
+        Fill();
+        return iterator(this);
+    }
+
+    std::optional<Entity> EntityCursor::Next()
+    {
+        Fill();
+        if (position == page.size())
+            return std::nullopt;
+        return std::move(page[position++]);
+    }
+
+    void Entity::SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows, std::complex<double>* out, std::uint8_t* errors) const
+    {
+        assert(values != nullptr || rows == 0);
+        assert(out != nullptr && errors != nullptr);
+        auto handles = Internal::GetHandles(vars);
+        Internal::NativeArray nVars{ Internal::CheckedCount(handles.size(), "Variable count"), handles.data() };
+        HandleErrorCode(entity_substitute_many(
+            innerEntityInstance.get()->GetReference(),
+            nVars,
+            values,
+            Internal::CheckedCount(rows, "Row count"),
+            reinterpret_cast<Internal::DoubleTuple*>(out),
+            errors
+        ));
+    }
+
+    void Entity::SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows, double* out, std::uint8_t* errors) const
+    {
+        std::vector<std::complex<double>> buffer(rows);
+        SubstituteMany(vars, values, rows, buffer.data(), errors);
+        Internal::ComplexToReal(buffer.data(), rows, out, errors);
+    }
+
+    NumericBatch<std::complex<double>> Entity::SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows) const
+    {
+        NumericBatch<std::complex<double>> res;
+        res.values.resize(rows);
+        res.errors.resize(rows);
+        SubstituteMany(vars, values, rows, res.values.data(), res.errors.data());
+        return res;
+    }
+
+    NumericBatch<double> Entity::SubstituteManyReal(const std::vector<Entity>& vars, const double* values, size_t rows) const
+    {
+        NumericBatch<double> res;
+        res.values.resize(rows);
+        res.errors.resize(rows);
+        SubstituteMany(vars, values, rows, res.values.data(), res.errors.data());
+        return res;
+    }
+
+    NumericBatch<std::complex<double>> Entity::SubstituteGrid(const std::vector<Entity>& vars, const std::vector<std::vector<double>>& axes) const
+    {
+        assert(vars.size() == axes.size());
+        size_t rows = axes.empty() ? 0 : 1;
+        std::vector<double> flatAxes;
+        std::vector<std::int32_t> lengths;
+        for (const auto& axis : axes)
+        {
+            lengths.push_back(Internal::CheckedCount(axis.size(), "Axis length"));
+            rows = (size_t)Internal::CheckedCount(rows * axis.size(), "Row count");
+            flatAxes.insert(flatAxes.end(), axis.begin(), axis.end());
+        }
+        NumericBatch<std::complex<double>> res;
+        res.values.resize(rows);
+        res.errors.resize(rows);
+        if (rows == 0)
+            return res;
+        auto handles = Internal::GetHandles(vars);
+        Internal::NativeArray nVars{ Internal::CheckedCount(handles.size(), "Variable count"), handles.data() };
+        HandleErrorCode(entity_substitute_grid(
+            innerEntityInstance.get()->GetReference(),
+            nVars,
+            flatAxes.data(),
+            lengths.data(),
+            reinterpret_cast<Internal::DoubleTuple*>(res.values.data()),
+            res.errors.data()
+        ));
+        return res;
+    }
+
+    NumericBatch<double> Entity::SubstituteGridReal(const std::vector<Entity>& vars, const std::vector<std::vector<double>>& axes) const
+    {
+        auto complexRes = SubstituteGrid(vars, axes);
+        NumericBatch<double> res;
+        res.values.resize(complexRes.values.size());
+        res.errors = std::move(complexRes.errors);
+        Internal::ComplexToReal(complexRes.values.data(), complexRes.values.size(), res.values.data(), res.errors.data());
+        return res;
+    }
+
+    CompiledFunction Entity::Compile(const std::vector<Entity>& vars) const
+    {
+        TraceSpan span("Entity::Compile");
+        return CompileFused({ *this }, vars);
+    }
+
+    BooleanFunction Entity::CompileBoolean(const std::vector<Entity>& vars) const
+    {
+        TraceSpan span("Entity::CompileBoolean");
+        auto varHandles = Internal::GetHandles(vars);
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        Internal::NativeBuffer nRes;
+        HandleErrorCode(entity_compile_boolean(innerEntityInstance.get()->GetReference(), nVars, &nRes));
+        return BooleanFunction(Internal::ToInstructions(nRes), vars.size());
+    }
+
+    RationalFunction Entity::CompileRational(const std::vector<Entity>& vars) const
+    {
+        TraceSpan span("Entity::CompileRational");
+        auto varHandles = Internal::GetHandles(vars);
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        Internal::NativeBuffer nInstructions, nConstants;
+        HandleErrorCode(entity_compile_rational(innerEntityInstance.get()->GetReference(), nVars, &nInstructions, &nConstants));
+        auto data = static_cast<const Internal::LongTuple*>(nConstants.data);
+        std::vector<Rational> constants(nConstants.length);
+        for (size_t i = 0; i < constants.size(); i++)
+            constants[i] = Rational{ data[i].first, data[i].second };
+        (void)free_native_buffer(nConstants);
+        return RationalFunction(Internal::ToInstructions(nInstructions), std::move(constants), *this, vars);
+    }
+
+    std::string Entity::EmitCpp(const std::string& name, const std::vector<Entity>& vars) const
+    {
+        std::vector<std::string> argNames(vars.size());
+        for (size_t i = 0; i < vars.size(); i++)
+            argNames[i] = vars[i].ToString();
+        return Compile(vars).EmitCpp(name, argNames);
+    }
+
+    CompiledFunction CompileFused(const std::vector<Entity>& outputs, const std::vector<Entity>& vars)
+    {
+        auto outputHandles = Internal::GetHandles(outputs);
+        auto varHandles = Internal::GetHandles(vars);
+        Internal::NativeArray nOutputs{ Internal::CheckedCount(outputHandles.size(), "Output count"), outputHandles.data() };
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        Internal::NativeBuffer nRes;
+        HandleErrorCode(entity_compile_fused(nOutputs, nVars, &nRes));
+        return Internal::ToCompiledFunction(nRes, vars.size());
+    }
+
+    Matrix::Matrix(Entity entity)
+        : entity(std::move(entity))
+    {
+        std::int32_t nRows, nColumns;
+        HandleErrorCode(matrix_shape(GetHandle(this->entity), &nRows, &nColumns));
+        rows = nRows;
+        columns = nColumns;
+    }
+
+    Matrix Matrix::FromBuffer(const double* values, size_t rows, size_t columns)
+    {
+        Internal::EntityRef res;
+        HandleErrorCode(matrix_from_buffer(values, Internal::CheckedCount(rows, "Row count"), Internal::CheckedCount(columns, "Column count"), false, &res));
+        return Matrix(CreateByHandle(res));
+    }
+
+    Matrix Matrix::FromBuffer(const std::complex<double>* values, size_t rows, size_t columns)
+    {
+        Internal::EntityRef res;
+        HandleErrorCode(matrix_from_buffer(reinterpret_cast<const double*>(values), Internal::CheckedCount(rows, "Row count"), Internal::CheckedCount(columns, "Column count"), true, &res));
+        return Matrix(CreateByHandle(res));
+    }
+
+    void Matrix::ToBuffer(std::complex<double>* out) const
+    {
+        HandleErrorCode(matrix_to_buffer(GetHandle(entity), true, reinterpret_cast<double*>(out)));
+    }
+
+    void Matrix::ToBuffer(double* out) const
+    {
+        HandleErrorCode(matrix_to_buffer(GetHandle(entity), false, out));
+    }
+
+    CompiledFunction Matrix::Compile(const std::vector<Entity>& vars) const
+    {
+        auto handles = Internal::GetHandles(vars);
+        Internal::NativeArray nVars{ Internal::CheckedCount(handles.size(), "Variable count"), handles.data() };
+        Internal::NativeBuffer nRes;
+        HandleErrorCode(matrix_compile(GetHandle(entity), nVars, &nRes));
+        return Internal::ToCompiledFunction(nRes, vars.size());
+    }
+
+    std::vector<std::vector<Entity>> EquationSystem::Solve(const std::vector<Entity>& vars) const
+    {
+        auto equationHandles = Internal::GetHandles(equations);
+        auto varHandles = Internal::GetHandles(vars);
+        Internal::NativeArray nEquations{ Internal::CheckedCount(equationHandles.size(), "Equation count"), equationHandles.data() };
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        std::int32_t solutionCount;
+        Internal::NativeArray nRes;
+        HandleErrorCode(equation_system_solve(nEquations, nVars, &solutionCount, &nRes));
+        std::vector<std::vector<Entity>> res(solutionCount, std::vector<Entity>(vars.size()));
+        for (size_t i = 0; i < (size_t)nRes.length; i++)
+            res[i / vars.size()][i % vars.size()] = CreateByHandle(nRes.refs[i]);
+        (void)free_native_array(nRes);
+        return res;
+    }
+
+    CompiledFunction EquationSystem::CompileSolutions(const std::vector<Entity>& vars, const std::vector<Entity>& params) const
+    {
+        std::vector<Entity> flattened;
+        for (const auto& solution : Solve(vars))
+            flattened.insert(flattened.end(), solution.begin(), solution.end());
+        return CompileFused(flattened, params);
+    }
+
+    SystemSolutions EquationSystem::SolveMany(const std::vector<Entity>& vars, const std::vector<Entity>& params, const double* values, size_t rows) const
+    {
+        assert(values != nullptr || rows == 0);
+        auto compiled = CompileSolutions(vars, params);
+        SystemSolutions res;
+        res.varCount = vars.size();
+        res.solutionCount = vars.empty() ? 0 : compiled.OutputCount() / vars.size();
+        res.values.resize(rows * compiled.OutputCount());
+        res.errors.resize(rows);
+        std::vector<std::complex<double>> args(params.size());
+        for (size_t row = 0; row < rows; row++)
+        {
+            for (size_t i = 0; i < args.size(); i++)
+                args[i] = values[row * args.size() + i];
+            auto out = res.values.data() + row * compiled.OutputCount();
+            compiled.Evaluate(args.data(), out);
+            for (size_t i = 0; i < compiled.OutputCount(); i++)
+                if (!std::isfinite(out[i].real()) || !std::isfinite(out[i].imag()))
+                    res.errors[row] = 1;
+        }
+        return res;
+    }
+
+    bool Entity::EvaluateGrid(const Entity& xVar, const Entity& yVar, GridRange xRange, GridRange yRange, size_t nx, size_t ny, float* out, const GridOptions& options) const
+    {
+        return AngouriMath::EvaluateGrid(Compile({ xVar, yVar }), xRange, yRange, nx, ny, out, options);
+    }
+
+    bool Entity::EvaluateGrid(const Entity& xVar, const Entity& yVar, const Entity& zVar, GridRange xRange, GridRange yRange, GridRange zRange, size_t nx, size_t ny, size_t nz, float* out, const GridOptions& options) const
+    {
+        return AngouriMath::EvaluateGrid(Compile({ xVar, yVar, zVar }), xRange, yRange, zRange, nx, ny, nz, out, options);
+    }
+
+    IntegrationResult Entity::IntegrateNumeric(const Entity& var, double a, double b, double tolerance) const
+    {
+        QuadratureOptions options;
+        options.tolerance = tolerance;
+        return AngouriMath::IntegrateNumeric(Compile({ var }), a, b, options);
+    }
+
+    std::vector<IntegrationResult> Entity::IntegrateNumeric(const Entity& var, const std::vector<std::pair<double, double>>& intervals, double tolerance) const
+    {
+        QuadratureOptions options;
+        options.tolerance = tolerance;
+        return AngouriMath::IntegrateNumeric(Compile({ var }), intervals, options);
+    }
+
+    std::vector<PolynomialTerm> Entity::PolynomialTerms(const Entity& var) const
+    {
+        Internal::NativeBuffer nRes;
+        HandleErrorCode(entity_as_polynomial(innerEntityInstance.get()->GetReference(), GetHandle(var), &nRes));
+        auto terms = static_cast<const Internal::NativePolynomialTerm*>(nRes.data);
+        std::vector<PolynomialTerm> res(nRes.length);
+        for (size_t i = 0; i < res.size(); i++)
+        {
+            const auto& term = terms[i];
+            res[i] = PolynomialTerm{ (std::uint32_t)term.power, { term.real, term.imaginary }, term.isRational != 0, term.numerator, term.denominator };
+        }
+        (void)free_native_buffer(nRes);
+        return res;
+    }
+
+    TaylorSurrogate Entity::CompileTaylor(const Entity& var, double point, int order, double radius) const
+    {
+        assert(radius >= 0.0);
+        Internal::NativeBuffer nCoefficients, nRemainder;
+        HandleErrorCode(entity_taylor(innerEntityInstance.get()->GetReference(), GetHandle(var), point, order, &nCoefficients, &nRemainder));
+        auto coefficients = static_cast<const std::complex<double>*>(nCoefficients.data);
+        Polynomial terms(std::vector<std::complex<double>>(coefficients, coefficients + nCoefficients.length));
+        (void)free_native_buffer(nCoefficients);
+        auto remainder = Internal::ToCompiledFunction(nRemainder, 1);
+
+        // Lagrange remainder: max |f^(n+1)| * radius^(n+1) / (n+1)!, the maximum is sampled
+        constexpr int samples = 257;
+        double maxDerivative = 0.0;
+        for (int i = 0; i < samples; i++)
+        {
+            std::complex<double> x = point + radius * (2.0 * i / (samples - 1) - 1.0);
+            std::complex<double> value;
+            remainder.Evaluate(&x, &value);
+            auto abs = std::abs(value);
+            maxDerivative = std::isfinite(abs) ? std::max(maxDerivative, abs) : std::numeric_limits<double>::infinity();
+        }
+        double errorBound = maxDerivative;
+        for (int k = 1; k <= order + 1; k++)
+            errorBound *= radius / k;
+        if (std::isnan(errorBound))
+            errorBound = std::numeric_limits<double>::infinity();
+        return TaylorSurrogate(std::move(terms), point, radius, errorBound);
+    }
+
     std::int64_t Entity::AsInteger() const
     {
         std::int64_t res;
@@ -184,6 +772,22 @@ namespace AngouriMath
         return std::complex<double>(res.first, res.second);
     }
 
+    bool Entity::operator==(const Entity& other) const
+    {
+        TraceSpan span("Entity::operator==");
+        auto self = innerEntityInstance.get();
+        auto that = other.innerEntityInstance.get();
+        if (self == that)
+            return true;
+        if (self == nullptr || that == nullptr)
+            return false;
+        if (self->CachedHash() != that->CachedHash())
+            return false;
+        Internal::NativeBool res;
+        HandleErrorCode(op_entity_equal(self->GetReference(), that->GetReference(), &res));
+        return res != 0;
+    }
+
     Internal::EntityRef GetHandle(const Entity& e)
     {
         return e.innerEntityInstance.get()->GetReference();
@@ -237,6 +841,7 @@ namespace AngouriMath
         {
             constexpr auto fact = [](Internal::EntityRef ref)
             {
+                TraceSpan span("Entity::ToString");
                 char* buff = nullptr;
                 HandleErrorCode(entity_to_string(ref, &buff));
                 auto res = buff != nullptr ? std::string(buff) : std::string();
@@ -245,5 +850,16 @@ namespace AngouriMath
             };
             return string.GetValue(fact, GetReference());
         }
+
+        std::uint64_t EntityInstance::CachedHash()
+        {
+            constexpr auto fact = [](Internal::EntityRef ref)
+            {
+                std::uint64_t res;
+                HandleErrorCode(entity_structural_hash(ref, &res));
+                return res;
+            };
+            return hash.GetValue(fact, GetReference());
+        }
     }
 }
@@ -2,17 +2,33 @@
 
 #include "TypeAliases.h"
 #include "ErrorCode.h"
+#include "AmgouriMathException.h"
 #include "FieldCache.h"
+#include "BooleanFunction.h"
+#include "CompiledFunction.h"
+#include "GarbageCollector.h"
+#include "GridEvaluation.h"
+#include "Polynomial.h"
+#include "Quadrature.h"
+#include "RationalFunction.h"
+#include "Settings.h"
+#include "SimplificationCache.h"
+#include "Startup.h"
+#include "Tracing.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <ostream>
 #include <vector>
 #include <complex>
+#include <iterator>
+#include <optional>
 
 namespace AngouriMath
 {
     class Entity;
+    class EntityCursor;
 }
 
 namespace AngouriMath::Internal
@@ -27,6 +43,7 @@ namespace AngouriMath::Internal
         FieldCache<std::shared_ptr<Entity>> innerEvaled;
         FieldCache<std::shared_ptr<Entity>> innerSimplified;
         FieldCache<std::string> string;
+        FieldCache<std::uint64_t> hash;
         EntityRef reference;
     public:
         EntityInstance(EntityRef reference) : reference(reference) { }
@@ -39,6 +56,7 @@ namespace AngouriMath::Internal
         const Entity& CachedEvaled();
         const Entity& CachedInnerSimplified();
         const std::string& CachedString();
+        std::uint64_t CachedHash();
     };
 }
 
@@ -51,6 +69,62 @@ namespace AngouriMath
         Right = 2
     };
 
+    // Result of a bulk numerical substitution, one entry per row
+    template<typename T>
+    struct NumericBatch
+    {
+        std::vector<T> values;
+        // non-zero where the row hit a pole or an undefined value
+        std::vector<std::uint8_t> errors;
+    };
+
+    // How a root of SolveEquationNumeric was found
+    enum class RootKind : std::uint8_t
+    {
+        Exact = 0,
+        // by the Newton solver, after the analytical solver gave up
+        Newton = 1,
+        // the solution evaluates to an infinity or NaN
+        NonFinite = 2,
+        // the solution cannot be evaluated to a number, e.g. depends on other variables
+        Symbolic = 3
+    };
+
+    // Roots of one or more equations; non-finite and symbolic roots are NaN
+    struct NumericRoots
+    {
+        std::vector<std::complex<double>> values;
+        std::vector<RootKind> kinds;
+        // roots of the i-th equation are in [offsets[i], offsets[i + 1])
+        std::vector<size_t> offsets;
+    };
+
+    // Budget of Entity::Simplify, zero limits are unbounded
+    struct SimplifyOptions
+    {
+        int level = 2;
+        // how many candidate forms may be rated before the search is abandoned
+        size_t maxAlternatives = 0;
+        // expressions with more nodes are not searched at all
+        size_t maxNodes = 0;
+    };
+
+    struct SimplifyReport
+    {
+        size_t alternativesExplored = 0;
+        // the search was abandoned and the shallow inner simplification returned instead
+        bool budgetExceeded = false;
+        std::chrono::nanoseconds elapsed{};
+    };
+
+    struct IncrementalSimplifyReport
+    {
+        // subtrees simplified by this call
+        size_t simplified = 0;
+        // subtrees whose results were remembered from earlier calls
+        size_t reused = 0;
+    };
+
     class Entity
     {
         explicit Entity(Internal::EntityRef handle);
@@ -69,11 +143,67 @@ namespace AngouriMath
         Entity Integrate(const Entity& var) const;
         Entity Solve(const Entity& var) const;
         Entity SolveEquation(const Entity& var) const;
+        NumericRoots SolveEquationNumeric(const Entity& var) const;
         Entity Limit(const Entity& var, const Entity& dest) const;
         Entity Limit(const Entity& var, const Entity& dest, ApproachFrom from) const;
         Entity Simplify() const;
+        // Bypasses the simplification cache
+        Entity Simplify(const SimplifyOptions& options, SimplifyReport* report = nullptr) const;
         std::vector<Entity> Alternate() const;
+        // Lazy counterparts of Nodes() and Alternate(), see EntityCursor
+        EntityCursor NodesCursor(size_t maxPageSize = 1024) const;
+        EntityCursor AlternateCursor(size_t maxPageSize = 16) const;
+        // Simplifies every node bottom up together with `window` levels of its simplified
+        // children and remembers the results by structural hash, so after Replace or
+        // Substitute only the path from the edit to the root is simplified again. Rewrites
+        // spanning more than `window` levels are not found, unlike by Simplify.
+        Entity SimplifyIncremental(int level = 2, int window = 2, IncrementalSimplifyReport* report = nullptr) const;
+
+        // Substitution, the untouched subtrees stay shared with this expression
+        Entity Substitute(const Entity& x, const Entity& value) const;
+        // All at once, so a value may contain the other variables
+        Entity Substitute(const std::vector<Entity>& vars, const std::vector<Entity>& values) const;
+        // Replaces the node itself, taken from Nodes(), DirectChildren() or a cursor of this
+        // expression, and not the subtrees equal to it; throws if it is not one of them
+        Entity Replace(const Entity& node, const Entity& replacement) const;
+
+        // Bulk numerical substitution
+        // values is a row-major rows x vars.size() matrix, one row per substitution
+        void SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows, std::complex<double>* out, std::uint8_t* errors) const;
+        void SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows, double* out, std::uint8_t* errors) const;
+        NumericBatch<std::complex<double>> SubstituteMany(const std::vector<Entity>& vars, const double* values, size_t rows) const;
+        NumericBatch<double> SubstituteManyReal(const std::vector<Entity>& vars, const double* values, size_t rows) const;
+        // Cartesian product of axes, one axis per variable; the last variable varies fastest
+        NumericBatch<std::complex<double>> SubstituteGrid(const std::vector<Entity>& vars, const std::vector<std::vector<double>>& axes) const;
+        NumericBatch<double> SubstituteGridReal(const std::vector<Entity>& vars, const std::vector<std::vector<double>>& axes) const;
+
+        // Compilation into a natively evaluated program
+        CompiledFunction Compile(const std::vector<Entity>& vars) const;
+        // Bit-parallel evaluator of a formula of not, and, or, xor and implies over boolean
+        // variables, throws if the expression has other nodes
+        BooleanFunction CompileBoolean(const std::vector<Entity>& vars) const;
+        // Exact evaluator over rational variables, throws if the expression has other
+        // operations or constants which are not 64-bit rationals
+        RationalFunction CompileRational(const std::vector<Entity>& vars) const;
+        // Dependency-free C++ source of the function, see CompiledFunction::EmitCpp
+        std::string EmitCpp(const std::string& name, const std::vector<Entity>& vars) const;
 
+        // Compiles the expression once and evaluates it over the grid in parallel,
+        // see AngouriMath::EvaluateGrid for the layout; returns false if cancelled
+        bool EvaluateGrid(const Entity& xVar, const Entity& yVar, GridRange xRange, GridRange yRange, size_t nx, size_t ny, float* out, const GridOptions& options = {}) const;
+        bool EvaluateGrid(const Entity& xVar, const Entity& yVar, const Entity& zVar, GridRange xRange, GridRange yRange, GridRange zRange, size_t nx, size_t ny, size_t nz, float* out, const GridOptions& options = {}) const;
+
+        // Definite integral over a finite interval by native adaptive quadrature of the
+        // once compiled integrand, see AngouriMath::IntegrateNumeric
+        IntegrationResult IntegrateNumeric(const Entity& var, double a, double b, double tolerance = 1e-10) const;
+        std::vector<IntegrationResult> IntegrateNumeric(const Entity& var, const std::vector<std::pair<double, double>>& intervals, double tolerance = 1e-10) const;
+
+        // Polynomial over var with numeric coefficients, throws if it is not one
+        std::vector<PolynomialTerm> PolynomialTerms(const Entity& var) const;
+        Polynomial AsPolynomial(const Entity& var) const { return Polynomial(PolynomialTerms(var)); }
+        // Taylor polynomial of the given order around point; the truncation error over
+        // |var - point| <= radius is estimated from the next derivative sampled there
+        TaylorSurrogate CompileTaylor(const Entity& var, double point, int order, double radius) const;
 
         // Casts
         std::int64_t AsInteger() const;
@@ -89,10 +219,159 @@ namespace AngouriMath
         const Entity InnerSimplified() const { return innerEntityInstance.get()->CachedInnerSimplified(); }
         const Entity Evaled() const { return innerEntityInstance.get()->CachedEvaled(); }
 
+        // Structural comparison
+        // The hash is stable between processes, equal expressions have equal hashes
+        std::uint64_t StructuralHash() const { return innerEntityInstance.get()->CachedHash(); }
+        bool operator==(const Entity& other) const;
+        bool operator!=(const Entity& other) const { return !(*this == other); }
+
         friend Internal::EntityRef GetHandle(const Entity& e);
         friend Entity CreateByHandle(Internal::EntityRef handle);
     };
 
+    // Forward-only range over a managed enumerator of entities. Elements are fetched
+    // in pages which start at one element and double up to maxPageSize, so the first
+    // elements arrive without the rest being enumerated or marshalled. The enumerator
+    // is released once it is exhausted, on Close() or when the cursor is destroyed,
+    // e. g. after breaking out of a loop over it. begin() continues where the last
+    // iteration stopped.
+    class EntityCursor
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Entity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Entity*;
+            using reference = const Entity&;
+
+            iterator() = default;
+
+            reference operator*() const { return cursor->page[cursor->position]; }
+            pointer operator->() const { return &**this; }
+            iterator& operator++() { cursor->Advance(); return *this; }
+            void operator++(int) { cursor->Advance(); }
+            // all the iterators of an exhausted cursor are equal to end()
+            bool operator==(const iterator& other) const { return AtEnd() == other.AtEnd(); }
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+
+        private:
+            friend class EntityCursor;
+            explicit iterator(EntityCursor* cursor) : cursor(cursor) { }
+            bool AtEnd() const { return cursor == nullptr || cursor->position == cursor->page.size(); }
+
+            EntityCursor* cursor = nullptr;
+        };
+
+        EntityCursor(EntityCursor&& other) noexcept;
+        EntityCursor& operator=(EntityCursor&& other) noexcept;
+        EntityCursor(const EntityCursor&) = delete;
+        EntityCursor& operator=(const EntityCursor&) = delete;
+        ~EntityCursor() { Close(); }
+
+        iterator begin();
+        iterator end() { return iterator(); }
+        // The next element, nullopt once the cursor is exhausted
+        std::optional<Entity> Next();
+        // Releases the managed enumerator, the already fetched elements can still be read
+        void Close();
+
+    private:
+        friend class Entity;
+        EntityCursor(Internal::CursorRef handle, size_t maxPageSize);
+        void Advance();
+        // fetches the next page once the current one is read
+        void Fill();
+
+        Internal::CursorRef handle = 0;
+        bool open = false;
+        size_t nextPageSize = 1;
+        size_t maxPageSize = 1;
+        std::vector<Entity> page;
+        size_t position = 0;
+    };
+
+    // Compiles all the outputs into one program, common subexpressions
+    // of different outputs are computed once per evaluation
+    CompiledFunction CompileFused(const std::vector<Entity>& outputs, const std::vector<Entity>& vars);
+
+    // Numerical roots of every equation over var in one call
+    NumericRoots SolveEquationsNumeric(const std::vector<Entity>& equations, const Entity& var);
+
+    // Forgets the results remembered by Entity::SimplifyIncremental
+    void ClearIncrementalSimplification();
+
+    // Parses with the native parser only, nullopt if the expression is outside
+    // of its subset; Entity(expr) tries it first and falls back to ParseManaged
+    std::optional<Entity> ParseNative(const std::string& expr);
+    // Parses with the full parser of the library
+    Entity ParseManaged(const std::string& expr);
+
+    // Matrix entity whose numeric elements cross the boundary in a single transfer.
+    // All the buffers are row-major.
+    class Matrix
+    {
+    public:
+        // Throws if the entity is not a matrix
+        explicit Matrix(Entity entity);
+        static Matrix FromBuffer(const double* values, size_t rows, size_t columns);
+        static Matrix FromBuffer(const std::complex<double>* values, size_t rows, size_t columns);
+
+        size_t RowCount() const { return rows; }
+        size_t ColumnCount() const { return columns; }
+        const Entity& AsEntity() const { return entity; }
+
+        // out must fit RowCount() x ColumnCount() elements, which are evaluated first
+        void ToBuffer(std::complex<double>* out) const;
+        // Throws if an element is not real
+        void ToBuffer(double* out) const;
+
+        // The i-th output is the i-th element, so Evaluate(args, out) writes
+        // the matrix at the given point into out
+        CompiledFunction Compile(const std::vector<Entity>& vars) const;
+
+    private:
+        Entity entity;
+        size_t rows = 0;
+        size_t columns = 0;
+    };
+
+    // Dense solutions of a batch of systems, values is a row-major
+    // rows x solutionCount x varCount tensor
+    struct SystemSolutions
+    {
+        size_t solutionCount = 0;
+        size_t varCount = 0;
+        std::vector<std::complex<double>> values;
+        // non-zero where the solution of the row hit a pole or an undefined value
+        std::vector<std::uint8_t> errors;
+    };
+
+    // System of equations, each of which is equal to zero
+    class EquationSystem
+    {
+    public:
+        EquationSystem(std::vector<Entity> equations) : equations(std::move(equations)) { }
+
+        const std::vector<Entity>& Equations() const { return equations; }
+
+        // One row per solution and one column per variable, empty if no solution was found
+        std::vector<std::vector<Entity>> Solve(const std::vector<Entity>& vars) const;
+
+        // Solves the system once with params left symbolic and compiles the solutions,
+        // the outputs are the flattened solution matrix, so OutputCount() / vars.size()
+        // is the number of solutions
+        CompiledFunction CompileSolutions(const std::vector<Entity>& vars, const std::vector<Entity>& params) const;
+        // values is a row-major rows x params.size() matrix of coefficients, every row
+        // is substituted into the once solved system natively
+        SystemSolutions SolveMany(const std::vector<Entity>& vars, const std::vector<Entity>& params, const double* values, size_t rows) const;
+
+    private:
+        std::vector<Entity> equations;
+    };
+
     inline std::ostream& operator<<(std::ostream& out, const AngouriMath::Entity& e)
     {
         out << e.ToString();
@@ -106,4 +385,13 @@ namespace std
     {
         return e.ToString();
     }
+
+    template<>
+    struct hash<AngouriMath::Entity>
+    {
+        size_t operator()(const AngouriMath::Entity& e) const
+        {
+            return (size_t)e.StructuralHash();
+        }
+    };
 }
\ No newline at end of file
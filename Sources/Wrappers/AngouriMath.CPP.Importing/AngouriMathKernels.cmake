@@ -0,0 +1,31 @@
+# angourimath_generate_kernels(<target> <kernels file>)
+#
+# Generates standalone C++ functions out of the kernels file (one
+# "name(x, y) = expression" per line) and makes them available to <target>
+# as "<target>.kernels.h". The generated header has no dependency on
+# AngouriMath, so the compiler can inline and vectorise the kernels and
+# the managed runtime is never loaded for them.
+#
+# The generator has to call into the exported library, so the header is
+# produced at build time (and regenerated whenever the kernels file changes).
+
+function(angourimath_generate_kernels TARGET KERNELS_FILE)
+	get_filename_component(KERNELS_FILE ${KERNELS_FILE} ABSOLUTE)
+	set(OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}.kernels)
+	set(OUTPUT_FILE ${OUTPUT_DIR}/${TARGET}.kernels.h)
+	# the generator leaves an unchanged header alone, so the stamp records that it ran
+	set(STAMP_FILE ${OUTPUT_DIR}/${TARGET}.kernels.stamp)
+
+	add_custom_command(
+		OUTPUT ${STAMP_FILE}
+		BYPRODUCTS ${OUTPUT_FILE}
+		COMMAND ${CMAKE_COMMAND} -E make_directory ${OUTPUT_DIR}
+		COMMAND AngouriMath.KernelGenerator ${KERNELS_FILE} ${OUTPUT_FILE}
+		COMMAND ${CMAKE_COMMAND} -E touch ${STAMP_FILE}
+		DEPENDS ${KERNELS_FILE} AngouriMath.KernelGenerator
+		COMMENT "Generating AngouriMath kernels for ${TARGET}"
+		VERBATIM)
+
+	target_sources(${TARGET} PRIVATE ${STAMP_FILE} ${OUTPUT_FILE})
+	target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "BooleanFunction.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        using Block = BooleanFunction::Block;
+        constexpr size_t BlockWords = BooleanFunction::BlockWords;
+        // blocks a thread takes at once when evaluating a truth table
+        constexpr size_t TableTile = 256;
+        // blocks evaluated before SatisfyingAssignments checks whether it found enough
+        constexpr size_t SatisfyingChunk = 4096;
+
+        inline unsigned PopCount(std::uint64_t x)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return (unsigned)__popcnt64(x);
+#else
+            return (unsigned)__builtin_popcountll(x);
+#endif
+        }
+
+        inline unsigned TrailingZeros(std::uint64_t x)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long res;
+            _BitScanForward64(&res, x);
+            return (unsigned)res;
+#else
+            return (unsigned)__builtin_ctzll(x);
+#endif
+        }
+
+        // load(k, block) fills the block with the values of the k-th variable
+        template<typename Load>
+        void RunBlock(const std::vector<Instruction>& program, Load&& load, Block* slots, Block& out)
+        {
+            for (size_t i = 0; i < program.size(); i++)
+            {
+                const auto& ins = program[i];
+                auto& res = slots[i];
+                switch (ins.opCode)
+                {
+                case OpCode::Variable: load(ins.first, res); break;
+                case OpCode::Constant: res.fill(ins.value.real() != 0.0 ? ~std::uint64_t(0) : 0); break;
+                case OpCode::Output: out = slots[ins.first]; break;
+
+                case OpCode::Not:
+                {
+                    const auto& a = slots[ins.first];
+                    for (size_t l = 0; l < BlockWords; l++)
+                        res[l] = ~a[l];
+                    break;
+                }
+                case OpCode::And:
+                case OpCode::Or:
+                case OpCode::Xor:
+                case OpCode::Implies:
+                {
+                    const auto& a = slots[ins.first];
+                    const auto& b = slots[ins.second];
+                    // the branch is per block, the lanes are branchless
+                    if (ins.opCode == OpCode::And)
+                        for (size_t l = 0; l < BlockWords; l++) res[l] = a[l] & b[l];
+                    else if (ins.opCode == OpCode::Or)
+                        for (size_t l = 0; l < BlockWords; l++) res[l] = a[l] | b[l];
+                    else if (ins.opCode == OpCode::Xor)
+                        for (size_t l = 0; l < BlockWords; l++) res[l] = a[l] ^ b[l];
+                    else
+                        for (size_t l = 0; l < BlockWords; l++) res[l] = ~a[l] | b[l];
+                    break;
+                }
+
+                default: assert(false && "Not a boolean instruction"); break;
+                }
+            }
+        }
+
+        std::vector<Block>& BooleanScratch(size_t size)
+        {
+            thread_local std::vector<Block> scratch;
+            if (scratch.size() < size)
+                scratch.resize(size);
+            return scratch;
+        }
+
+        // Bit j of word w of the truth table is assignment 64 w + j, so the 6 lowest variables
+        // follow the same pattern in every word and the others are constant over a word
+        constexpr std::uint64_t LowVariableMasks[6] = {
+            0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+            0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+        };
+    }
+
+    BooleanFunction::BooleanFunction(std::vector<Instruction> instructions, size_t varCount)
+        : instructions(std::move(instructions)), varCount(varCount)
+    {
+    }
+
+    void BooleanFunction::EvaluateMany(const std::uint64_t* args, size_t words, std::uint64_t* out) const
+    {
+        auto& slots = Internal::BooleanScratch(instructions.size());
+        for (size_t begin = 0; begin < words; begin += BlockWords)
+        {
+            const size_t lanes = std::min(BlockWords, words - begin);
+            Block res;
+            Internal::RunBlock(instructions, [&](std::int32_t k, Block& block)
+            {
+                block.fill(0);
+                std::copy(args + k * words + begin, args + k * words + begin + lanes, block.begin());
+            }, slots.data(), res);
+            std::copy(res.begin(), res.begin() + lanes, out + begin);
+        }
+    }
+
+    std::uint64_t BooleanFunction::Evaluate(const std::uint64_t* args) const
+    {
+        std::uint64_t res;
+        EvaluateMany(args, 1, &res);
+        return res;
+    }
+
+    bool BooleanFunction::operator()(const std::vector<bool>& args) const
+    {
+        assert(args.size() == varCount);
+        std::vector<std::uint64_t> words(varCount);
+        for (size_t k = 0; k < varCount; k++)
+            words[k] = args[k] ? 1 : 0;
+        return (Evaluate(words.data()) & 1) != 0;
+    }
+
+    size_t BooleanFunction::TableWords() const
+    {
+        assert(varCount < 64 + 6 && "The truth table does not fit the memory");
+        return varCount <= 6 ? 1 : size_t(1) << (varCount - 6);
+    }
+
+    void BooleanFunction::EvaluateTable(size_t first, size_t count, Block* out, unsigned threads) const
+    {
+        const size_t tiles = (count + Internal::TableTile - 1) / Internal::TableTile;
+        unsigned threadCount = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        threadCount = (unsigned)std::min<size_t>(threadCount, tiles);
+        // assignments past 2^varCount, which only exist when it is less than a word
+        const std::uint64_t valid = varCount < 6 ? (std::uint64_t(1) << (std::uint64_t(1) << varCount)) - 1 : ~std::uint64_t(0);
+
+        std::atomic<size_t> nextTile{ 0 };
+        auto work = [&]()
+        {
+            auto& slots = Internal::BooleanScratch(instructions.size());
+            for (size_t tile = nextTile++; tile < tiles; tile = nextTile++)
+            {
+                const size_t end = std::min((tile + 1) * Internal::TableTile, count);
+                for (size_t block = tile * Internal::TableTile; block < end; block++)
+                {
+                    const size_t word = (first + block) * BlockWords;
+                    Internal::RunBlock(instructions, [&](std::int32_t k, Block& res)
+                    {
+                        if (k < 6)
+                            res.fill(Internal::LowVariableMasks[k]);
+                        else
+                            for (size_t l = 0; l < BlockWords; l++)
+                                res[l] = (((word + l) >> (k - 6)) & 1) != 0 ? ~std::uint64_t(0) : 0;
+                    }, slots.data(), out[block]);
+                    out[block][0] &= valid;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned thread = 1; thread < threadCount; thread++)
+            workers.emplace_back(work);
+        work();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    std::vector<std::uint64_t> BooleanFunction::TruthTable(unsigned threads) const
+    {
+        const size_t words = TableWords();
+        std::vector<Block> blocks((words + BlockWords - 1) / BlockWords);
+        EvaluateTable(0, blocks.size(), blocks.data(), threads);
+        std::vector<std::uint64_t> res(words);
+        for (size_t w = 0; w < words; w++)
+            res[w] = blocks[w / BlockWords][w % BlockWords];
+        return res;
+    }
+
+    std::uint64_t BooleanFunction::CountSatisfying(unsigned threads) const
+    {
+        const size_t words = TableWords();
+        const size_t blocks = (words + BlockWords - 1) / BlockWords;
+        std::vector<Block> chunk(std::min(blocks, Internal::SatisfyingChunk));
+        std::uint64_t res = 0;
+        for (size_t first = 0; first < blocks; first += chunk.size())
+        {
+            const size_t count = std::min(chunk.size(), blocks - first);
+            EvaluateTable(first, count, chunk.data(), threads);
+            for (size_t b = 0; b < count; b++)
+                for (size_t l = 0; l < BlockWords && (first + b) * BlockWords + l < words; l++)
+                    res += Internal::PopCount(chunk[b][l]);
+        }
+        return res;
+    }
+
+    std::vector<std::uint64_t> BooleanFunction::SatisfyingAssignments(size_t maxCount, unsigned threads) const
+    {
+        const size_t words = TableWords();
+        const size_t blocks = (words + BlockWords - 1) / BlockWords;
+        std::vector<Block> chunk(std::min(blocks, Internal::SatisfyingChunk));
+        std::vector<std::uint64_t> res;
+        for (size_t first = 0; first < blocks && res.size() < maxCount; first += chunk.size())
+        {
+            const size_t count = std::min(chunk.size(), blocks - first);
+            EvaluateTable(first, count, chunk.data(), threads);
+            for (size_t b = 0; b < count; b++)
+                for (size_t l = 0; l < BlockWords; l++)
+                {
+                    const std::uint64_t word = (first + b) * BlockWords + l;
+                    if (word >= words)
+                        break;
+                    for (auto bits = chunk[b][l]; bits != 0 && res.size() < maxCount; bits &= bits - 1)
+                        res.push_back(word * 64 + Internal::TrailingZeros(bits));
+                }
+        }
+        return res;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CompiledFunction.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace AngouriMath
+{
+    // Natively evaluated boolean formula, bit-parallel over assignments: bit j of the
+    // k-th argument word is the value of the k-th variable in the j-th assignment, and
+    // bit j of the result is the value of the formula in it. Blocks of BlockWords words
+    // are evaluated per instruction, which the compiler turns into SIMD operations.
+    class BooleanFunction
+    {
+    public:
+        static constexpr size_t BlockWords = 8;
+        using Block = std::array<std::uint64_t, BlockWords>;
+
+        BooleanFunction() = default;
+        BooleanFunction(std::vector<Instruction> instructions, size_t varCount);
+
+        size_t VarCount() const { return varCount; }
+        const std::vector<Instruction>& Instructions() const { return instructions; }
+
+        bool operator()(const std::vector<bool>& args) const;
+        // 64 assignments, args holds VarCount() words
+        std::uint64_t Evaluate(const std::uint64_t* args) const;
+        // args is a row-major VarCount() x words matrix, out receives words words
+        void EvaluateMany(const std::uint64_t* args, size_t words, std::uint64_t* out) const;
+
+        // Bit i (least significant first) is the value at the i-th assignment, in which
+        // the k-th variable is bit k of i. Takes 2^VarCount() bits, at least one word;
+        // 0 threads uses all the hardware threads.
+        std::vector<std::uint64_t> TruthTable(unsigned threads = 0) const;
+        std::uint64_t CountSatisfying(unsigned threads = 0) const;
+        // Satisfying assignments in the numbering of TruthTable, in increasing order;
+        // the table is evaluated in chunks, so it stops soon after maxCount are found
+        std::vector<std::uint64_t> SatisfyingAssignments(size_t maxCount = std::numeric_limits<size_t>::max(), unsigned threads = 0) const;
+
+    private:
+        // Evaluates the blocks [first, first + count) of the truth table into out
+        void EvaluateTable(size_t first, size_t count, Block* out, unsigned threads) const;
+        size_t TableWords() const;
+
+        std::vector<Instruction> instructions;
+        size_t varCount = 0;
+    };
+}
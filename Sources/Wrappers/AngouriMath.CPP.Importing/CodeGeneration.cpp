@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "CompiledFunction.h"
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        // Emitted once per translation unit, so several generated headers can be included together
+        constexpr const char* CppHelpers = R"(#ifndef ANGOURIMATH_GENERATED_KERNEL_HELPERS
+#define ANGOURIMATH_GENERATED_KERNEL_HELPERS
+namespace angourimath_kernels_detail
+{
+    inline double signum(double x) { return x != x ? x : (double)((x > 0.0) - (x < 0.0)); }
+    inline std::complex<double> signum(std::complex<double> x) { double a = std::abs(x); return a == 0.0 ? std::complex<double>() : x / a; }
+    inline double phi(double x)
+    {
+        if (!(x >= 1.0) || x > 9007199254740992.0) return std::numeric_limits<double>::quiet_NaN();
+        long long n = (long long)x, res = n;
+        for (long long p = 2; p * p <= n; p++)
+            if (n % p == 0) { while (n % p == 0) n /= p; res -= res / p; }
+        if (n > 1) res -= res / n;
+        return (double)res;
+    }
+    inline std::complex<double> phi(std::complex<double> x) { return phi(x.real()); }
+    inline std::complex<double> gamma(std::complex<double> z)
+    {
+        const double pi = 3.14159265358979323846;
+        const double c[] = { 0.99999999999980993, 676.5203681218851, -1259.1392167224028,
+            771.32342877765313, -176.61502916214059, 12.507343278686905,
+            -0.13857109526572012, 9.9843695780195716e-6, 1.5056327351493116e-7 };
+        if (z.real() < 0.5) return pi / (std::sin(pi * z) * gamma(1.0 - z));
+        z -= 1.0;
+        std::complex<double> x = c[0];
+        for (int i = 1; i < 9; i++) x += c[i] / (z + (double)i);
+        std::complex<double> t = z + 7.5;
+        return std::sqrt(2 * pi) * std::pow(t, z + 0.5) * std::exp(-t) * x;
+    }
+}
+#endif
+)";
+
+        constexpr const char* CHelpers = R"(static double am_signum(double x) { return x != x ? x : (double)((x > 0.0) - (x < 0.0)); }
+static inline double am_phi(double x)
+{
+    long long n, res, p;
+    if (!(x >= 1.0) || x > 9007199254740992.0) return NAN;
+    n = (long long)x;
+    res = n;
+    for (p = 2; p * p <= n; p++)
+        if (n % p == 0) { while (n % p == 0) n /= p; res -= res / p; }
+    if (n > 1) res -= res / n;
+    return (double)res;
+}
+)";
+
+        std::string DoubleLiteral(double value)
+        {
+            if (value != value)
+                return "std::numeric_limits<double>::quiet_NaN()";
+            if (value == std::numeric_limits<double>::infinity())
+                return "std::numeric_limits<double>::infinity()";
+            if (value == -std::numeric_limits<double>::infinity())
+                return "(-std::numeric_limits<double>::infinity())";
+            char buff[64];
+            std::snprintf(buff, sizeof(buff), "%.17g", value);
+            std::string res = buff;
+            if (res.find_first_of(".eE") == std::string::npos)
+                res += ".0";
+            return value < 0 ? "(" + res + ")" : res;
+        }
+
+        // x^2 is emitted as x * x and so on, which keeps the function constexpr and exact
+        constexpr int MaxUnrolledPower = 4;
+
+        int UnrolledPower(const Instruction& ins, const std::vector<Instruction>& program)
+        {
+            if (ins.opCode != OpCode::Pow || program[ins.second].opCode != OpCode::Constant)
+                return 0;
+            auto exponent = program[ins.second].value;
+            for (int power = 1; power <= MaxUnrolledPower; power++)
+                if (exponent == std::complex<double>((double)power))
+                    return power;
+            return 0;
+        }
+
+        bool IsArithmeticOnly(const std::vector<Instruction>& program)
+        {
+            for (const auto& ins : program)
+                switch (ins.opCode)
+                {
+                case OpCode::Variable: case OpCode::Constant: case OpCode::Output:
+                case OpCode::Sum: case OpCode::Minus: case OpCode::Mul: case OpCode::Div:
+                    break;
+                case OpCode::Pow:
+                    if (UnrolledPower(ins, program) == 0)
+                        return false;
+                    break;
+                default:
+                    return false;
+                }
+            return true;
+        }
+
+        enum class Dialect
+        {
+            Cpp,
+            CppComplex,
+            C
+        };
+
+        std::string MathCall(Dialect dialect, const char* function, const std::string& args)
+        {
+            return (dialect == Dialect::C ? "" : "std::") + std::string(function) + "(" + args + ")";
+        }
+
+        std::string HelperCall(Dialect dialect, const char* function, const std::string& args)
+        {
+            return (dialect == Dialect::C ? "am_" : "angourimath_kernels_detail::") + std::string(function) + "(" + args + ")";
+        }
+
+        // Right-hand side of the slot computed by ins, operands are referred to by slot names
+        std::string Expression(const Instruction& ins, const std::vector<std::string>& slots, Dialect dialect)
+        {
+            const auto& a = ins.first >= 0 && (size_t)ins.first < slots.size() ? slots[ins.first] : std::string();
+            const auto& b = ins.second >= 0 && (size_t)ins.second < slots.size() ? slots[ins.second] : std::string();
+            switch (ins.opCode)
+            {
+            case OpCode::Sin: return MathCall(dialect, "sin", a);
+            case OpCode::Cos: return MathCall(dialect, "cos", a);
+            case OpCode::Secant: return "1.0 / " + MathCall(dialect, "cos", a);
+            case OpCode::Cosecant: return "1.0 / " + MathCall(dialect, "sin", a);
+            case OpCode::Tan: return MathCall(dialect, "tan", a);
+            case OpCode::Cotan: return "1.0 / " + MathCall(dialect, "tan", a);
+            case OpCode::Arcsin: return MathCall(dialect, "asin", a);
+            case OpCode::Arccos: return MathCall(dialect, "acos", a);
+            case OpCode::Arctan: return MathCall(dialect, "atan", a);
+            case OpCode::Arccotan: return MathCall(dialect, "atan", "1.0 / " + a);
+            case OpCode::Arcsecant: return MathCall(dialect, "acos", "1.0 / " + a);
+            case OpCode::Arccosecant: return MathCall(dialect, "asin", "1.0 / " + a);
+            case OpCode::Factorial:
+                return dialect == Dialect::CppComplex
+                    ? HelperCall(dialect, "gamma", a + " + 1.0")
+                    : MathCall(dialect, "tgamma", a + " + 1.0");
+            case OpCode::Signum: return HelperCall(dialect, "signum", a);
+            case OpCode::Abs:
+                switch (dialect)
+                {
+                case Dialect::CppComplex: return "std::complex<double>(std::abs(" + a + "))";
+                case Dialect::C: return "fabs(" + a + ")";
+                default: return "std::abs(" + a + ")";
+                }
+            case OpCode::Phi: return HelperCall(dialect, "phi", a);
+
+            case OpCode::Sum: return a + " + " + b;
+            case OpCode::Minus: return a + " - " + b;
+            case OpCode::Mul: return a + " * " + b;
+            case OpCode::Div: return a + " / " + b;
+            case OpCode::Pow: return MathCall(dialect, "pow", a + ", " + b);
+            case OpCode::Log: return MathCall(dialect, "log", b) + " / " + MathCall(dialect, "log", a);
+            default:
+                assert(false && "Unknown instruction");
+                return std::string();
+            }
+        }
+
+        std::string ConstantLiteral(std::complex<double> value, Dialect dialect)
+        {
+            if (dialect == Dialect::CppComplex)
+                return "std::complex<double>(" + DoubleLiteral(value.real()) + ", " + DoubleLiteral(value.imag()) + ")";
+            auto real = value.imag() == 0.0 ? value.real() : std::numeric_limits<double>::quiet_NaN();
+            if (dialect == Dialect::C && !std::isfinite(real))
+                return real != real ? "NAN" : real > 0 ? "INFINITY" : "(-INFINITY)";
+            return DoubleLiteral(real);
+        }
+
+        // Declares one local per computed slot and calls emitOutput for every Output instruction
+        template<typename OutputEmitter>
+        void EmitBody(std::ostringstream& out, const std::vector<Instruction>& program, const std::vector<std::string>& argNames,
+            Dialect dialect, const char* indent, OutputEmitter&& emitOutput)
+        {
+            const std::string type = dialect == Dialect::CppComplex ? "std::complex<double>" : "double";
+            std::vector<std::string> slots(program.size());
+            for (size_t i = 0; i < program.size(); i++)
+            {
+                const auto& ins = program[i];
+                switch (ins.opCode)
+                {
+                case OpCode::Variable:
+                    slots[i] = argNames[ins.first];
+                    break;
+                case OpCode::Constant:
+                    slots[i] = ConstantLiteral(ins.value, dialect);
+                    break;
+                case OpCode::Output:
+                    emitOutput(ins.second, slots[ins.first]);
+                    break;
+                default:
+                    slots[i] = "am_t" + std::to_string(i);
+                    out << indent << "const " << type << " " << slots[i] << " = ";
+                    if (auto power = UnrolledPower(ins, program))
+                        for (int j = 0; j < power; j++)
+                            out << (j == 0 ? "" : " * ") << slots[ins.first];
+                    else
+                        out << Expression(ins, slots, dialect);
+                    out << ";\n";
+                    break;
+                }
+            }
+        }
+
+        void EmitCppOverload(std::ostringstream& out, const std::string& name, const std::vector<Instruction>& program,
+            const std::vector<std::string>& argNames, size_t outputCount, bool isComplex)
+        {
+            const std::string type = isComplex ? "std::complex<double>" : "double";
+            const bool constexprable = !isComplex && IsArithmeticOnly(program);
+
+            out << (constexprable ? "constexpr " : "inline ") << (outputCount == 1 ? type : "void") << " " << name << "(";
+            for (size_t i = 0; i < argNames.size(); i++)
+                out << (i == 0 ? "" : ", ") << type << " " << argNames[i];
+            if (outputCount != 1)
+                out << (argNames.empty() ? "" : ", ") << type << "* out";
+            out << ")\n{\n";
+
+            EmitBody(out, program, argNames, isComplex ? Dialect::CppComplex : Dialect::Cpp, "    ",
+                [&](std::int32_t index, const std::string& value)
+                {
+                    if (outputCount == 1)
+                        out << "    return " << value << ";\n";
+                    else
+                        out << "    out[" << index << "] = " << value << ";\n";
+                });
+            out << "}\n";
+        }
+
+        bool IsIdentifier(const std::string& name)
+        {
+            // C++17 keywords and alternative tokens, the namespace and the output parameter
+            // the emitted code refers to
+            static const char* keywords[] = {
+                "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+                "case", "catch", "char", "char16_t", "char32_t", "class", "compl", "const", "constexpr",
+                "const_cast", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+                "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+                "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+                "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+                "reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_assert",
+                "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true",
+                "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+                "volatile", "wchar_t", "while", "xor", "xor_eq",
+                "std", "out"
+            };
+            if (name.empty() || !(std::isalpha((unsigned char)name[0]) || name[0] == '_'))
+                return false;
+            for (char c : name)
+                if (!(std::isalnum((unsigned char)c) || c == '_'))
+                    return false;
+            for (const char* keyword : keywords)
+                if (name == keyword)
+                    return false;
+            // reserved for temporaries and unnamed arguments
+            return name.rfind("am_", 0) != 0;
+        }
+    }
+
+    std::string CompiledFunction::EmitCpp(const std::string& name, const std::vector<std::string>& argNames) const
+    {
+        assert(argNames.empty() || argNames.size() == varCount);
+        std::vector<std::string> names(varCount);
+        for (size_t i = 0; i < varCount; i++)
+            names[i] = i < argNames.size() && Internal::IsIdentifier(argNames[i]) ? argNames[i] : "am_arg" + std::to_string(i);
+
+        std::ostringstream out;
+        out << "// This function is auto-generated by AngouriMath.\n";
+        out << "#include <cmath>\n#include <complex>\n#include <limits>\n\n";
+        out << Internal::CppHelpers << "\n";
+        Internal::EmitCppOverload(out, name, instructions, names, outputCount, false);
+        // without parameters the two overloads would only differ by the return type
+        if (varCount > 0 || outputCount != 1)
+        {
+            out << "\n";
+            Internal::EmitCppOverload(out, name, instructions, names, outputCount, true);
+        }
+        return out.str();
+    }
+
+    std::string CompiledFunction::EmitC(const std::string& name) const
+    {
+        std::vector<std::string> argNames(varCount);
+        for (size_t i = 0; i < varCount; i++)
+            argNames[i] = "args[" + std::to_string(i) + "]";
+
+        std::ostringstream out;
+        out << "/* This function is auto-generated by AngouriMath. */\n";
+        out << "#include <math.h>\n#include <stddef.h>\n\n";
+        out << Internal::CHelpers << "\n";
+        out << "static void " << name << "_row(const double* args, double* out)\n{\n";
+        Internal::EmitBody(out, instructions, argNames, Internal::Dialect::C, "    ",
+            [&](std::int32_t index, const std::string& value)
+            {
+                out << "    out[" << index << "] = " << value << ";\n";
+            });
+        out << "}\n\n";
+        out << "void " << name << "(const double* args, size_t rows, double* out)\n{\n";
+        out << "    size_t row;\n";
+        out << "    for (row = 0; row < rows; row++)\n";
+        out << "        " << name << "_row(args + row * " << varCount << ", out + row * " << outputCount << ");\n";
+        out << "}\n";
+        return out.str();
+    }
+}
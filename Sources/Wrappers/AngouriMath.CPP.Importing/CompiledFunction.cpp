@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "CompiledFunction.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+        constexpr double Pi = 3.14159265358979323846;
+
+        template<typename T>
+        T ConstantOf(const Instruction& instruction);
+
+        template<>
+        double ConstantOf<double>(const Instruction& instruction)
+        {
+            return instruction.value.imag() == 0.0 ? instruction.value.real() : NaN;
+        }
+
+        template<>
+        std::complex<double> ConstantOf<std::complex<double>>(const Instruction& instruction)
+        {
+            return instruction.value;
+        }
+
+        inline double Signum(double x)
+        {
+            if (std::isnan(x))
+                return x;
+            return (double)((x > 0.0) - (x < 0.0));
+        }
+
+        inline std::complex<double> Signum(std::complex<double> x)
+        {
+            auto abs = std::abs(x);
+            return abs == 0.0 ? std::complex<double>() : x / abs;
+        }
+
+        inline double Abs(double x) { return std::abs(x); }
+        inline std::complex<double> Abs(std::complex<double> x) { return std::abs(x); }
+
+        inline double Factorial(double x) { return std::tgamma(x + 1.0); }
+
+        // Lanczos approximation, the same as in FastExpression
+        std::complex<double> Gamma(std::complex<double> z)
+        {
+            constexpr int g = 7;
+            constexpr double coeffs[] = {
+                0.99999999999980993,  676.5203681218851,     -1259.1392167224028,
+                771.32342877765313,   -176.61502916214059,   12.507343278686905,
+                -0.13857109526572012, 9.9843695780195716e-6, 1.5056327351493116e-7
+            };
+            if (z.real() < 0.5)
+                return Pi / (std::sin(Pi * z) * Gamma(1.0 - z));
+            z -= 1.0;
+            std::complex<double> x = coeffs[0];
+            for (int i = 1; i < g + 2; i++)
+                x += coeffs[i] / (z + (double)i);
+            auto t = z + (g + 0.5);
+            return std::sqrt(2 * Pi) * std::pow(t, z + 0.5) * std::exp(-t) * x;
+        }
+
+        inline std::complex<double> Factorial(std::complex<double> x) { return Gamma(x + 1.0); }
+
+        // Euler's totient of the integer part
+        inline double Phi(double x)
+        {
+            if (!(x >= 1.0) || x > 9007199254740992.0)
+                return NaN;
+            auto n = (std::int64_t)x;
+            auto res = n;
+            for (std::int64_t p = 2; p * p <= n; p++)
+                if (n % p == 0)
+                {
+                    while (n % p == 0)
+                        n /= p;
+                    res -= res / p;
+                }
+            if (n > 1)
+                res -= res / n;
+            return (double)res;
+        }
+
+        inline std::complex<double> Phi(std::complex<double> x) { return Phi(x.real()); }
+
+        template<typename T>
+        void Run(const std::vector<Instruction>& program, const T* args, T* out, T* slots)
+        {
+            for (size_t i = 0; i < program.size(); i++)
+            {
+                const auto& ins = program[i];
+                switch (ins.opCode)
+                {
+                case OpCode::Variable: slots[i] = args[ins.first]; break;
+                case OpCode::Constant: slots[i] = ConstantOf<T>(ins); break;
+                case OpCode::Output: out[ins.second] = slots[ins.first]; break;
+
+                case OpCode::Sin: slots[i] = std::sin(slots[ins.first]); break;
+                case OpCode::Cos: slots[i] = std::cos(slots[ins.first]); break;
+                case OpCode::Secant: slots[i] = 1.0 / std::cos(slots[ins.first]); break;
+                case OpCode::Cosecant: slots[i] = 1.0 / std::sin(slots[ins.first]); break;
+                case OpCode::Tan: slots[i] = std::tan(slots[ins.first]); break;
+                case OpCode::Cotan: slots[i] = 1.0 / std::tan(slots[ins.first]); break;
+                case OpCode::Arcsin: slots[i] = std::asin(slots[ins.first]); break;
+                case OpCode::Arccos: slots[i] = std::acos(slots[ins.first]); break;
+                case OpCode::Arctan: slots[i] = std::atan(slots[ins.first]); break;
+                case OpCode::Arccotan: slots[i] = std::atan(1.0 / slots[ins.first]); break;
+                case OpCode::Arcsecant: slots[i] = std::acos(1.0 / slots[ins.first]); break;
+                case OpCode::Arccosecant: slots[i] = std::asin(1.0 / slots[ins.first]); break;
+                case OpCode::Factorial: slots[i] = Factorial(slots[ins.first]); break;
+                case OpCode::Signum: slots[i] = Signum(slots[ins.first]); break;
+                case OpCode::Abs: slots[i] = Abs(slots[ins.first]); break;
+                case OpCode::Phi: slots[i] = Phi(slots[ins.first]); break;
+
+                case OpCode::Sum: slots[i] = slots[ins.first] + slots[ins.second]; break;
+                case OpCode::Minus: slots[i] = slots[ins.first] - slots[ins.second]; break;
+                case OpCode::Mul: slots[i] = slots[ins.first] * slots[ins.second]; break;
+                case OpCode::Div: slots[i] = slots[ins.first] / slots[ins.second]; break;
+                case OpCode::Pow: slots[i] = std::pow(slots[ins.first], slots[ins.second]); break;
+                case OpCode::Log: slots[i] = std::log(slots[ins.second]) / std::log(slots[ins.first]); break;
+
+                default: assert(false && "Unknown instruction"); break;
+                }
+            }
+        }
+
+        template<typename T>
+        std::vector<T>& Scratch(size_t size)
+        {
+            thread_local std::vector<T> scratch;
+            if (scratch.size() < size)
+                scratch.resize(size);
+            return scratch;
+        }
+    }
+
+    CompiledFunction::CompiledFunction(std::vector<Instruction> instructions, size_t varCount)
+        : instructions(std::move(instructions)), varCount(varCount)
+    {
+        for (const auto& ins : this->instructions)
+            if (ins.opCode == OpCode::Output)
+                outputCount++;
+    }
+
+    void CompiledFunction::Evaluate(const std::complex<double>* args, std::complex<double>* out) const
+    {
+        auto& slots = Internal::Scratch<std::complex<double>>(instructions.size());
+        Internal::Run(instructions, args, out, slots.data());
+    }
+
+    void CompiledFunction::Evaluate(const double* args, double* out) const
+    {
+        if (jitted != nullptr)
+            return jitted(args, 1, out);
+        auto& slots = Internal::Scratch<double>(instructions.size());
+        Internal::Run(instructions, args, out, slots.data());
+    }
+
+    std::complex<double> CompiledFunction::operator()(const std::vector<std::complex<double>>& args) const
+    {
+        assert(args.size() == varCount && outputCount > 0);
+        std::vector<std::complex<double>> out(outputCount);
+        Evaluate(args.data(), out.data());
+        return out[0];
+    }
+
+    void CompiledFunction::EvaluateMany(const std::complex<double>* args, size_t rows, std::complex<double>* out) const
+    {
+        auto& slots = Internal::Scratch<std::complex<double>>(instructions.size());
+        for (size_t row = 0; row < rows; row++)
+            Internal::Run(instructions, args + row * varCount, out + row * outputCount, slots.data());
+    }
+
+    void CompiledFunction::EvaluateMany(const double* args, size_t rows, double* out) const
+    {
+        if (jitted != nullptr)
+            return jitted(args, rows, out);
+        auto& slots = Internal::Scratch<double>(instructions.size());
+        for (size_t row = 0; row < rows; row++)
+            Internal::Run(instructions, args + row * varCount, out + row * outputCount, slots.data());
+    }
+}
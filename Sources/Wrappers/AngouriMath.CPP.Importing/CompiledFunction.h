@@ -0,0 +1,111 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AngouriMath
+{
+    // Kept in sync with NativeOpCode in AngouriMath.CPP.Exporting
+    enum class OpCode : std::int32_t
+    {
+        Variable = 0,
+        Constant = 1,
+        Output = 2,
+
+        // 1-arg functions
+        Sin = 50,
+        Cos,
+        Secant,
+        Cosecant,
+        Tan,
+        Cotan,
+        Arcsin,
+        Arccos,
+        Arctan,
+        Arccotan,
+        Arcsecant,
+        Arccosecant,
+        Factorial,
+        Signum,
+        Abs,
+        Phi,
+
+        // 2-arg functions
+        Sum = 100,
+        Minus,
+        Mul,
+        Div,
+        Pow,
+        Log,
+
+        // boolean programs only, see BooleanFunction
+        Not = 150,
+        And = 200,
+        Or,
+        Xor,
+        Implies,
+    };
+
+    // The i-th instruction computes the i-th slot out of the slots before it.
+    // For Variable, first is the variable index; for Output, first is the slot
+    // and second is the output index.
+    struct Instruction
+    {
+        OpCode opCode;
+        std::int32_t first;
+        std::int32_t second;
+        std::complex<double> value;
+    };
+
+    // Natively evaluated program with any number of outputs, no managed calls
+    // are made once it is compiled.
+    class CompiledFunction
+    {
+    public:
+        CompiledFunction() = default;
+        CompiledFunction(std::vector<Instruction> instructions, size_t varCount);
+
+        size_t VarCount() const { return varCount; }
+        size_t OutputCount() const { return outputCount; }
+        const std::vector<Instruction>& Instructions() const { return instructions; }
+
+        // args holds VarCount() values, out receives OutputCount() values
+        void Evaluate(const std::complex<double>* args, std::complex<double>* out) const;
+        // Real arithmetic only, non-real intermediate results become NaN
+        void Evaluate(const double* args, double* out) const;
+        // Returns the first output
+        std::complex<double> operator()(const std::vector<std::complex<double>>& args) const;
+
+        // args is a row-major rows x VarCount() matrix,
+        // out is a row-major rows x OutputCount() matrix
+        void EvaluateMany(const std::complex<double>* args, size_t rows, std::complex<double>* out) const;
+        void EvaluateMany(const double* args, size_t rows, double* out) const;
+
+        // Standalone C++ source with a double and a std::complex<double> overload of
+        // the function; argNames which are not valid identifiers are replaced
+        std::string EmitCpp(const std::string& name, const std::vector<std::string>& argNames = {}) const;
+        // C source of void name(const double* args, size_t rows, double* out) with the
+        // same layout as EvaluateMany
+        std::string EmitC(const std::string& name) const;
+
+        // Compiles the program to machine code with the C compiler found at configure time
+        // and from then on uses it for real evaluation. The library is cached on disk (in
+        // cacheDirectory, $ANGOURIMATH_JIT_CACHE or the user cache directory), so later runs
+        // load it without compiling. Returns false and keeps interpreting the program when
+        // no compiler is available or the compilation fails.
+        bool Jit(const std::string& cacheDirectory = {});
+        bool IsJitted() const { return jitted != nullptr; }
+
+    private:
+        using JitFunction = void (*)(const double* args, size_t rows, double* out);
+
+        std::vector<Instruction> instructions;
+        size_t varCount = 0;
+        size_t outputCount = 0;
+        std::shared_ptr<void> jitLibrary;
+        JitFunction jitted = nullptr;
+    };
+}
@@ -0,0 +1,648 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "ComputeServer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#define ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        // Every message is a frame header followed by size bytes of payload, which are either
+        // on the socket or, if inSharedMemory, at the start of the shared memory region. The
+        // exchange is strictly request-response, so both directions use the same region.
+        struct Frame
+        {
+            // RemoteOperation of requests, FrameStatus of responses
+            std::uint32_t kind;
+            std::uint32_t inSharedMemory;
+            std::uint64_t size;
+        };
+
+        enum class FrameStatus : std::uint32_t
+        {
+            Ok = 0,
+            Failed = 1,
+            // sent once by a worker after it mapped the shared memory
+            Ready = 2,
+        };
+
+        class PayloadWriter
+        {
+        public:
+            void Put(const std::string& str)
+            {
+                Put((std::uint64_t)str.size());
+                Put(str.data(), str.size());
+            }
+
+            void Put(std::uint64_t value) { Put(&value, sizeof(value)); }
+
+            void Put(const void* data, size_t size)
+            {
+                auto bytes = static_cast<const std::uint8_t*>(data);
+                buffer.insert(buffer.end(), bytes, bytes + size);
+            }
+
+            std::vector<std::uint8_t> buffer;
+        };
+
+        class PayloadReader
+        {
+        public:
+            PayloadReader(const std::uint8_t* data, size_t size) : data(data), size(size) { }
+
+            std::string String()
+            {
+                const auto length = (size_t)U64();
+                return std::string(reinterpret_cast<const char*>(Take(length)), length);
+            }
+
+            std::uint64_t U64()
+            {
+                std::uint64_t res;
+                std::memcpy(&res, Take(sizeof(res)), sizeof(res));
+                return res;
+            }
+
+            const std::uint8_t* Take(size_t count)
+            {
+                if (count > size - position)
+                    throw AngouriMathException(ErrorCode("AngouriMath.Server.ProtocolError", "Truncated payload", ""));
+                auto res = data + position;
+                position += count;
+                return res;
+            }
+
+        private:
+            const std::uint8_t* data;
+            size_t size;
+            size_t position = 0;
+        };
+
+        std::vector<std::uint8_t> Execute(RemoteOperation op, PayloadReader& request)
+        {
+            PayloadWriter res;
+            const Entity expr = request.String();
+            switch (op)
+            {
+            case RemoteOperation::Simplify: res.Put(expr.Simplify().ToString()); break;
+            case RemoteOperation::Differentiate: res.Put(expr.Differentiate(request.String()).ToString()); break;
+            case RemoteOperation::Integrate: res.Put(expr.Integrate(request.String()).ToString()); break;
+            case RemoteOperation::SolveEquation: res.Put(expr.SolveEquation(request.String()).ToString()); break;
+            case RemoteOperation::Latexise: res.Put(expr.Latexise()); break;
+            case RemoteOperation::Evaluate: res.Put(expr.Evaled().ToString()); break;
+            case RemoteOperation::SubstituteMany:
+            {
+                std::vector<Entity> vars(request.U64());
+                for (auto& var : vars)
+                    var = request.String();
+                const auto rows = (size_t)request.U64();
+                std::vector<double> values(rows * vars.size());
+                std::memcpy(values.data(), request.Take(values.size() * sizeof(double)), values.size() * sizeof(double));
+                auto batch = expr.SubstituteMany(vars, values.data(), rows);
+                res.Put(rows);
+                res.Put(batch.values.data(), rows * sizeof(std::complex<double>));
+                res.Put(batch.errors.data(), rows);
+                break;
+            }
+            default:
+                throw AngouriMathException(ErrorCode("AngouriMath.Server.ProtocolError", "Unknown operation " + std::to_string((std::uint32_t)op), ""));
+            }
+            return std::move(res.buffer);
+        }
+
+        // Runs the request in this process, errors are encoded into the response
+        std::vector<std::uint8_t> Dispatch(RemoteOperation op, const std::uint8_t* data, size_t size, FrameStatus& status)
+        {
+            PayloadWriter error;
+            try
+            {
+                PayloadReader request(data, size);
+                auto res = Execute(op, request);
+                status = FrameStatus::Ok;
+                return res;
+            }
+            catch (const AngouriMathException& e)
+            {
+                error.Put(e.Name());
+                error.Put(e.Message());
+                error.Put(e.StackTrace());
+            }
+            catch (const std::exception& e)
+            {
+                error.Put(std::string("AngouriMath.Server.NativeException"));
+                error.Put(std::string(e.what()));
+                error.Put(std::string());
+            }
+            status = FrameStatus::Failed;
+            return std::move(error.buffer);
+        }
+
+        std::vector<std::uint8_t> ThrowIfFailed(FrameStatus status, std::vector<std::uint8_t> response)
+        {
+            if (status == FrameStatus::Ok)
+                return response;
+            PayloadReader error(response.data(), response.size());
+            auto name = error.String();
+            auto message = error.String();
+            auto stackTrace = error.String();
+            throw AngouriMathException(ErrorCode(std::move(name), std::move(message), std::move(stackTrace)));
+        }
+
+        [[noreturn]] void ThrowServerError(const char* name, const std::string& message)
+        {
+            throw AngouriMathException(ErrorCode(name, message, ""));
+        }
+
+#ifdef ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+        using Clock = std::chrono::steady_clock;
+
+        enum class IoResult { Ok, TimedOut, Closed };
+
+        // With no deadline, waits indefinitely
+        IoResult WaitFor(int fd, short events, const Clock::time_point* deadline)
+        {
+            while (true)
+            {
+                int timeout = -1;
+                if (deadline != nullptr)
+                {
+                    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - Clock::now()).count();
+                    if (left <= 0)
+                        return IoResult::TimedOut;
+                    timeout = (int)std::min<long long>(left, 1 << 30);
+                }
+                pollfd pfd{ fd, events, 0 };
+                const int ready = poll(&pfd, 1, timeout);
+                if (ready < 0 && errno == EINTR)
+                    continue;
+                if (ready < 0)
+                    return IoResult::Closed;
+                if (ready > 0)
+                    return IoResult::Ok;
+            }
+        }
+
+        IoResult WriteAll(int fd, const void* data, size_t size, const Clock::time_point* deadline)
+        {
+            auto bytes = static_cast<const std::uint8_t*>(data);
+            while (size > 0)
+            {
+                if (auto wait = WaitFor(fd, POLLOUT, deadline); wait != IoResult::Ok)
+                    return wait;
+#ifdef MSG_NOSIGNAL
+                const auto written = send(fd, bytes, size, MSG_NOSIGNAL);
+#else
+                const auto written = send(fd, bytes, size, 0);
+#endif
+                if (written < 0 && (errno == EINTR || errno == EAGAIN))
+                    continue;
+                if (written <= 0)
+                    return IoResult::Closed;
+                bytes += written;
+                size -= (size_t)written;
+            }
+            return IoResult::Ok;
+        }
+
+        IoResult ReadAll(int fd, void* data, size_t size, const Clock::time_point* deadline)
+        {
+            auto bytes = static_cast<std::uint8_t*>(data);
+            while (size > 0)
+            {
+                if (auto wait = WaitFor(fd, POLLIN, deadline); wait != IoResult::Ok)
+                    return wait;
+                const auto read = recv(fd, bytes, size, 0);
+                if (read < 0 && (errno == EINTR || errno == EAGAIN))
+                    continue;
+                if (read <= 0)
+                    return IoResult::Closed;
+                bytes += read;
+                size -= (size_t)read;
+            }
+            return IoResult::Ok;
+        }
+
+        // Sends the payload through the shared memory if it fits
+        IoResult WriteFrame(int fd, std::uint32_t kind, const std::vector<std::uint8_t>& payload,
+            std::uint8_t* sharedMemory, size_t sharedMemorySize, const Clock::time_point* deadline)
+        {
+            Frame frame{ kind, payload.size() <= sharedMemorySize, payload.size() };
+            if (frame.inSharedMemory)
+                std::memcpy(sharedMemory, payload.data(), payload.size());
+            if (auto res = WriteAll(fd, &frame, sizeof(frame), deadline); res != IoResult::Ok || frame.inSharedMemory)
+                return res;
+            return WriteAll(fd, payload.data(), payload.size(), deadline);
+        }
+
+        IoResult ReadFrame(int fd, Frame& frame, std::vector<std::uint8_t>& payload,
+            const std::uint8_t* sharedMemory, size_t sharedMemorySize, const Clock::time_point* deadline)
+        {
+            if (auto res = ReadAll(fd, &frame, sizeof(frame), deadline); res != IoResult::Ok)
+                return res;
+            if (frame.inSharedMemory && frame.size > sharedMemorySize)
+                return IoResult::Closed;
+            payload.resize((size_t)frame.size);
+            if (frame.inSharedMemory)
+            {
+                std::memcpy(payload.data(), sharedMemory, payload.size());
+                return IoResult::Ok;
+            }
+            return ReadAll(fd, payload.data(), payload.size(), deadline);
+        }
+
+        void SetCloseOnExec(int fd)
+        {
+            fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+        }
+
+        std::string DefaultServerPath()
+        {
+            if (auto path = std::getenv("ANGOURIMATH_SERVER"); path != nullptr && *path != '\0')
+                return path;
+#ifdef ANGOURIMATH_SERVER_PATH
+            return ANGOURIMATH_SERVER_PATH;
+#else
+            return "AngouriMath.Server";
+#endif
+        }
+#endif
+    }
+
+#ifdef ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+    struct ComputeServerPool::Worker
+    {
+        pid_t pid = -1;
+        int socket = -1;
+        std::uint8_t* sharedMemory = nullptr;
+        size_t sharedMemorySize = 0;
+        size_t requests = 0;
+        size_t bytes = 0;
+
+        ~Worker() { Stop(false); }
+
+        // Spawns the server and waits until it maps the shared memory, false if it did not in time
+        bool Start(const ComputeServerOptions& options, Internal::Clock::time_point deadline)
+        {
+            static std::atomic<unsigned> counter{ 0 };
+            const auto name = "/angourimath-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+            const int shm = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (shm < 0)
+                Internal::ThrowServerError("AngouriMath.Server.SpawnFailed", "Cannot create the shared memory " + name);
+            sharedMemorySize = std::max<size_t>(options.sharedMemoryBytes, 1);
+            void* mapping = ftruncate(shm, (off_t)sharedMemorySize) == 0
+                ? mmap(nullptr, sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0)
+                : MAP_FAILED;
+            close(shm);
+            if (mapping == MAP_FAILED)
+            {
+                shm_unlink(name.c_str());
+                Internal::ThrowServerError("AngouriMath.Server.SpawnFailed", "Cannot map the shared memory " + name);
+            }
+            sharedMemory = static_cast<std::uint8_t*>(mapping);
+
+            // only the dup2-ed copy of the worker's end is inherited, so the worker's death closes the socket;
+            // where possible the ends are close-on-exec from the start, so concurrent spawns cannot inherit them
+            int fds[2];
+#ifdef SOCK_CLOEXEC
+            const int socketType = SOCK_STREAM | SOCK_CLOEXEC;
+#else
+            const int socketType = SOCK_STREAM;
+#endif
+            if (socketpair(AF_UNIX, socketType, 0, fds) != 0)
+            {
+                shm_unlink(name.c_str());
+                Internal::ThrowServerError("AngouriMath.Server.SpawnFailed", "Cannot create a socket pair");
+            }
+#ifndef SOCK_CLOEXEC
+            Internal::SetCloseOnExec(fds[0]);
+            Internal::SetCloseOnExec(fds[1]);
+#endif
+#ifdef SO_NOSIGPIPE
+            int on = 1;
+            setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            socket = fds[0];
+
+            const auto path = options.serverPath.empty() ? Internal::DefaultServerPath() : options.serverPath;
+            const auto size = std::to_string(sharedMemorySize);
+            std::vector<char*> argv{ const_cast<char*>(path.c_str()), const_cast<char*>("--fd"), const_cast<char*>("3"),
+                const_cast<char*>("--shm"), const_cast<char*>(name.c_str()), const_cast<char*>("--shm-size"), const_cast<char*>(size.c_str()), nullptr };
+            std::vector<std::string> environment;
+            for (auto env = environ; *env != nullptr; env++)
+                if (std::strncmp(*env, "DOTNET_GCHeapHardLimit=", 23) != 0 || options.heapLimitBytes == 0)
+                    environment.emplace_back(*env);
+            if (options.heapLimitBytes != 0)
+            {
+                char limit[64];
+                std::snprintf(limit, sizeof(limit), "DOTNET_GCHeapHardLimit=%zx", options.heapLimitBytes);
+                environment.emplace_back(limit);
+            }
+            std::vector<char*> envp;
+            for (auto& env : environment)
+                envp.push_back(env.data());
+            envp.push_back(nullptr);
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            // dup2 onto itself keeps the close-on-exec flag, so it has to be cleared by hand
+            if (fds[1] == 3)
+                fcntl(fds[1], F_SETFD, fcntl(fds[1], F_GETFD) & ~FD_CLOEXEC);
+            else
+                posix_spawn_file_actions_adddup2(&actions, fds[1], 3);
+            const int spawnError = posix_spawnp(&pid, path.c_str(), &actions, nullptr, argv.data(), envp.data());
+            posix_spawn_file_actions_destroy(&actions);
+            close(fds[1]);
+            if (spawnError != 0)
+            {
+                pid = -1;
+                shm_unlink(name.c_str());
+                Internal::ThrowServerError("AngouriMath.Server.SpawnFailed", "Cannot start " + path + ": " + std::strerror(spawnError));
+            }
+
+            Internal::Frame ready;
+            std::vector<std::uint8_t> payload;
+            const auto res = Internal::ReadFrame(socket, ready, payload, sharedMemory, sharedMemorySize, &deadline);
+            shm_unlink(name.c_str());
+            if (res == Internal::IoResult::TimedOut)
+                return false;
+            if (res != Internal::IoResult::Ok || ready.kind != (std::uint32_t)Internal::FrameStatus::Ready)
+                Internal::ThrowServerError("AngouriMath.Server.WorkerCrashed", "The worker exited while starting");
+            return true;
+        }
+
+        // Closing the socket lets the worker exit on its own, it is killed if it does not
+        void Stop(bool graceful)
+        {
+            if (socket >= 0)
+                close(socket);
+            socket = -1;
+            if (pid > 0)
+            {
+                int status;
+                auto waited = waitpid(pid, &status, WNOHANG);
+                for (int attempt = 0; graceful && waited == 0 && attempt < 100; attempt++)
+                {
+                    usleep(10000);
+                    waited = waitpid(pid, &status, WNOHANG);
+                }
+                if (waited == 0)
+                {
+                    kill(pid, SIGKILL);
+                    waitpid(pid, &status, 0);
+                }
+            }
+            pid = -1;
+            if (sharedMemory != nullptr)
+                munmap(sharedMemory, sharedMemorySize);
+            sharedMemory = nullptr;
+        }
+    };
+#else
+    struct ComputeServerPool::Worker { };
+#endif
+
+    ComputeServerPool::ComputeServerPool(ComputeServerOptions options)
+        : options(std::move(options))
+    {
+#ifndef ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+        this->options.inProcess = true;
+#endif
+        const unsigned count = std::max(this->options.workers, 1u);
+        workers.resize(count);
+        for (size_t i = count; i > 0; i--)
+            idle.push_back(i - 1);
+    }
+
+    ComputeServerPool::~ComputeServerPool() = default;
+
+    std::vector<std::uint8_t> ComputeServerPool::Call(RemoteOperation op, const std::vector<std::uint8_t>& payload, std::chrono::milliseconds deadline)
+    {
+        requests++;
+        if (options.inProcess)
+        {
+            Internal::FrameStatus status;
+            auto response = Internal::Dispatch(op, payload.data(), payload.size(), status);
+            return Internal::ThrowIfFailed(status, std::move(response));
+        }
+#ifdef ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+        const auto until = Internal::Clock::now() + (deadline.count() > 0 ? deadline : options.deadline);
+
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idleChanged.wait(lock, [this] { return !idle.empty(); });
+            slot = idle.back();
+            idle.pop_back();
+        }
+        // the slot is owned by this request until it is returned
+        struct Release
+        {
+            ComputeServerPool& pool;
+            size_t slot;
+            ~Release()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(pool.mutex);
+                    pool.idle.push_back(slot);
+                }
+                pool.idleChanged.notify_one();
+            }
+        } release{ *this, slot };
+
+        auto& worker = workers[slot];
+        if (worker != nullptr && (worker->requests >= options.maxRequestsPerWorker || worker->bytes >= options.maxBytesPerWorker))
+        {
+            worker->Stop(true);
+            worker = nullptr;
+            recycled++;
+        }
+        if (worker == nullptr)
+        {
+            auto fresh = std::make_unique<Worker>();
+            if (!fresh->Start(options, until))
+            {
+                timedOut++;
+                Internal::ThrowServerError("AngouriMath.Server.DeadlineExceeded", "The worker did not start in time");
+            }
+            spawned++;
+            worker = std::move(fresh);
+        }
+
+        Internal::Frame frame;
+        std::vector<std::uint8_t> response;
+        auto res = Internal::WriteFrame(worker->socket, (std::uint32_t)op, payload, worker->sharedMemory, worker->sharedMemorySize, &until);
+        if (res == Internal::IoResult::Ok)
+            res = Internal::ReadFrame(worker->socket, frame, response, worker->sharedMemory, worker->sharedMemorySize, &until);
+        if (res != Internal::IoResult::Ok)
+        {
+            worker = nullptr;
+            if (res == Internal::IoResult::TimedOut)
+            {
+                timedOut++;
+                Internal::ThrowServerError("AngouriMath.Server.DeadlineExceeded", "The request did not complete in time, its worker was killed");
+            }
+            crashed++;
+            Internal::ThrowServerError("AngouriMath.Server.WorkerCrashed", "The worker exited while serving the request");
+        }
+        worker->requests++;
+        worker->bytes += payload.size() + response.size();
+        return Internal::ThrowIfFailed((Internal::FrameStatus)frame.kind, std::move(response));
+#else
+        (void)deadline;
+        return {};
+#endif
+    }
+
+    std::string ComputeServerPool::CallForString(RemoteOperation op, const std::vector<std::string>& args, std::chrono::milliseconds deadline)
+    {
+        Internal::PayloadWriter request;
+        for (const auto& arg : args)
+            request.Put(arg);
+        const auto response = Call(op, request.buffer, deadline);
+        Internal::PayloadReader res(response.data(), response.size());
+        return res.String();
+    }
+
+    std::string ComputeServerPool::Simplify(const std::string& expr, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::Simplify, { expr }, deadline);
+    }
+
+    std::string ComputeServerPool::Differentiate(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::Differentiate, { expr, var }, deadline);
+    }
+
+    std::string ComputeServerPool::Integrate(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::Integrate, { expr, var }, deadline);
+    }
+
+    std::string ComputeServerPool::SolveEquation(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::SolveEquation, { expr, var }, deadline);
+    }
+
+    std::string ComputeServerPool::Latexise(const std::string& expr, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::Latexise, { expr }, deadline);
+    }
+
+    std::string ComputeServerPool::Evaluate(const std::string& expr, std::chrono::milliseconds deadline)
+    {
+        return CallForString(RemoteOperation::Evaluate, { expr }, deadline);
+    }
+
+    NumericBatch<std::complex<double>> ComputeServerPool::SubstituteMany(const std::string& expr, const std::vector<std::string>& vars,
+        const double* values, size_t rows, std::chrono::milliseconds deadline)
+    {
+        Internal::PayloadWriter request;
+        request.Put(expr);
+        request.Put((std::uint64_t)vars.size());
+        for (const auto& var : vars)
+            request.Put(var);
+        request.Put((std::uint64_t)rows);
+        request.Put(values, rows * vars.size() * sizeof(double));
+        const auto response = Call(RemoteOperation::SubstituteMany, request.buffer, deadline);
+
+        Internal::PayloadReader reader(response.data(), response.size());
+        NumericBatch<std::complex<double>> res;
+        res.values.resize((size_t)reader.U64());
+        res.errors.resize(res.values.size());
+        std::memcpy(res.values.data(), reader.Take(res.values.size() * sizeof(std::complex<double>)), res.values.size() * sizeof(std::complex<double>));
+        std::memcpy(res.errors.data(), reader.Take(res.errors.size()), res.errors.size());
+        return res;
+    }
+
+    ComputeServerStats ComputeServerPool::Stats() const
+    {
+        ComputeServerStats res;
+        res.requests = requests;
+        res.spawned = spawned;
+        res.recycled = recycled;
+        res.crashed = crashed;
+        res.timedOut = timedOut;
+        return res;
+    }
+
+    namespace Internal
+    {
+        int RunComputeServer(int argc, char** argv)
+        {
+#ifdef ANGOURIMATH_COMPUTE_SERVER_AVAILABLE
+            int fd = -1;
+            std::string name;
+            size_t sharedMemorySize = 0;
+            for (int i = 1; i + 1 < argc; i += 2)
+            {
+                const std::string key = argv[i];
+                if (key == "--fd")
+                    fd = std::atoi(argv[i + 1]);
+                else if (key == "--shm")
+                    name = argv[i + 1];
+                else if (key == "--shm-size")
+                    sharedMemorySize = (size_t)std::strtoull(argv[i + 1], nullptr, 10);
+            }
+            if (fd < 0 || name.empty() || sharedMemorySize == 0)
+            {
+                std::fprintf(stderr, "Usage: %s --fd <socket> --shm <name> --shm-size <bytes>\n"
+                    "Started by AngouriMath::ComputeServerPool, not meant to be run by hand\n", argv[0]);
+                return 2;
+            }
+            const int shm = shm_open(name.c_str(), O_RDWR, 0);
+            if (shm < 0)
+                return 1;
+            void* mapping = mmap(nullptr, sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+            close(shm);
+            if (mapping == MAP_FAILED)
+                return 1;
+            auto sharedMemory = static_cast<std::uint8_t*>(mapping);
+            SetCloseOnExec(fd);
+
+            if (WriteFrame(fd, (std::uint32_t)FrameStatus::Ready, {}, sharedMemory, sharedMemorySize, nullptr) != IoResult::Ok)
+                return 1;
+            Frame frame;
+            std::vector<std::uint8_t> request;
+            // the pool closing the socket is the signal to exit
+            while (ReadFrame(fd, frame, request, sharedMemory, sharedMemorySize, nullptr) == IoResult::Ok)
+            {
+                FrameStatus status;
+                const auto response = Dispatch((RemoteOperation)frame.kind, request.data(), request.size(), status);
+                if (WriteFrame(fd, (std::uint32_t)status, response, sharedMemory, sharedMemorySize, nullptr) != IoResult::Ok)
+                    break;
+            }
+            return 0;
+#else
+            (void)argc;
+            std::fprintf(stderr, "%s is not supported on this platform\n", argv[0]);
+            return 2;
+#endif
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "AngouriMath.h"
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AngouriMath
+{
+    // Kept in sync between the pool and AngouriMath.Server of the same build
+    enum class RemoteOperation : std::uint32_t
+    {
+        Simplify = 1,
+        Differentiate,
+        Integrate,
+        SolveEquation,
+        Latexise,
+        Evaluate,
+        SubstituteMany,
+    };
+
+    struct ComputeServerOptions
+    {
+        // empty uses $ANGOURIMATH_SERVER or the AngouriMath.Server built with this library
+        std::string serverPath;
+        // at most this many requests run at once, one per worker process
+        unsigned workers = 2;
+        // of a request which does not set its own; spawning a worker counts towards it
+        std::chrono::milliseconds deadline{ 30000 };
+        // a worker is replaced once it served this many requests or transferred this many payload bytes
+        size_t maxRequestsPerWorker = 10000;
+        size_t maxBytesPerWorker = size_t(1) << 30;
+        // shared with every worker, payloads which do not fit go through the socket
+        size_t sharedMemoryBytes = size_t(16) << 20;
+        // DOTNET_GCHeapHardLimit of the workers, 0 leaves the runtime default
+        size_t heapLimitBytes = 0;
+        // runs the requests in this process, e. g. in tests
+        bool inProcess = false;
+    };
+
+    struct ComputeServerStats
+    {
+        std::uint64_t requests = 0;
+        std::uint64_t spawned = 0;
+        // replaced after maxRequestsPerWorker or maxBytesPerWorker
+        std::uint64_t recycled = 0;
+        std::uint64_t crashed = 0;
+        std::uint64_t timedOut = 0;
+    };
+
+    // Pool of AngouriMath.Server processes, each hosting its own runtime, so a request
+    // which exhausts the heap or crashes takes down only its worker. Requests and
+    // results are strings, nothing symbolic runs in the calling process. Workers talk
+    // over a Unix domain socket and a shared memory region for the bulk payloads, and
+    // are spawned on demand.
+    //
+    // A request which misses its deadline kills its worker and throws AngouriMathException
+    // named AngouriMath.Server.DeadlineExceeded, a worker which dies throws
+    // AngouriMath.Server.WorkerCrashed; the worker is replaced on the next request.
+    // Exceptions of AngouriMath in a worker are rethrown as they are. Thread-safe.
+    // On Windows the requests always run in process.
+    class ComputeServerPool
+    {
+    public:
+        explicit ComputeServerPool(ComputeServerOptions options = {});
+        ~ComputeServerPool();
+        ComputeServerPool(const ComputeServerPool&) = delete;
+        ComputeServerPool& operator=(const ComputeServerPool&) = delete;
+
+        // A zero deadline uses the one of the options
+        std::string Simplify(const std::string& expr, std::chrono::milliseconds deadline = {});
+        std::string Differentiate(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline = {});
+        std::string Integrate(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline = {});
+        std::string SolveEquation(const std::string& expr, const std::string& var, std::chrono::milliseconds deadline = {});
+        std::string Latexise(const std::string& expr, std::chrono::milliseconds deadline = {});
+        // The evaluated form, see Entity::Evaled
+        std::string Evaluate(const std::string& expr, std::chrono::milliseconds deadline = {});
+        // values is a row-major rows x vars.size() matrix, see Entity::SubstituteMany
+        NumericBatch<std::complex<double>> SubstituteMany(const std::string& expr, const std::vector<std::string>& vars,
+            const double* values, size_t rows, std::chrono::milliseconds deadline = {});
+
+        ComputeServerStats Stats() const;
+
+    private:
+        struct Worker;
+
+        std::vector<std::uint8_t> Call(RemoteOperation op, const std::vector<std::uint8_t>& payload, std::chrono::milliseconds deadline);
+        std::string CallForString(RemoteOperation op, const std::vector<std::string>& args, std::chrono::milliseconds deadline);
+
+        ComputeServerOptions options;
+        mutable std::mutex mutex;
+        std::condition_variable idleChanged;
+        // null until the first request on the slot needs it
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<size_t> idle;
+        std::atomic<std::uint64_t> requests{ 0 };
+        std::atomic<std::uint64_t> spawned{ 0 };
+        std::atomic<std::uint64_t> recycled{ 0 };
+        std::atomic<std::uint64_t> crashed{ 0 };
+        std::atomic<std::uint64_t> timedOut{ 0 };
+    };
+
+    namespace Internal
+    {
+        // Entry point of AngouriMath.Server
+        int RunComputeServer(int argc, char** argv);
+    }
+}
@@ -28,6 +28,8 @@ namespace AngouriMath
         void HandleErrorCode(ErrorCode ec);
         void HandleErrorCode(NativeErrorCode nec);
         void HandleErrorCode(NativeErrorCode nec, ErrorCode& ec);
+        // counts cross the boundary as int32, larger ones throw System.ArgumentOutOfRangeException
+        std::int32_t CheckedCount(size_t count, const char* what);
     }
 }
 
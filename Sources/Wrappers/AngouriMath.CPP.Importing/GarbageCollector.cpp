@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "GarbageCollector.h"
+#include "ErrorCode.h"
+#include "Imports.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        void SetEnvironment(const char* name, const std::string& value)
+        {
+#ifdef _WIN32
+            (void)_putenv_s(name, value.c_str());
+#else
+            (void)setenv(name, value.c_str(), 1);
+#endif
+        }
+
+        // numeric settings of the runtime are hexadecimal
+        std::string Hex(size_t value)
+        {
+            char buff[32];
+            std::snprintf(buff, sizeof(buff), "%zx", value);
+            return buff;
+        }
+    }
+
+    bool ConfigureGarbageCollector(const GarbageCollectorOptions& options)
+    {
+        Internal::SetEnvironment("DOTNET_gcServer", options.server ? "1" : "0");
+        Internal::SetEnvironment("DOTNET_gcConcurrent", options.concurrent ? "1" : "0");
+        Internal::SetEnvironment("DOTNET_GCConserveMemory", Internal::Hex((size_t)options.conserveMemory));
+        if (options.heapHardLimit != 0)
+            Internal::SetEnvironment("DOTNET_GCHeapHardLimit", Internal::Hex(options.heapHardLimit));
+        HandleErrorCode(startup_runtime());
+
+        const auto info = GetGarbageCollectorInfo();
+        // the runtime does not always report concurrency and memory conservation back,
+        // but a runtime started in the other mode is enough to tell
+        return info.server == options.server
+            && (options.heapHardLimit == 0 || info.heapHardLimit == options.heapHardLimit);
+    }
+
+    GarbageCollectorInfo GetGarbageCollectorInfo()
+    {
+        Internal::NativeGcInfo native;
+        HandleErrorCode(gc_info(&native));
+        GarbageCollectorInfo res;
+        res.server = native.isServer != 0;
+        res.concurrent = native.isConcurrent != 0;
+        res.latencyMode = (GcLatencyMode)native.latencyMode;
+        res.conserveMemory = native.conserveMemory;
+        res.heapHardLimit = (std::uint64_t)native.heapHardLimitBytes;
+        res.heapSize = (std::uint64_t)native.heapSizeBytes;
+        res.committed = (std::uint64_t)native.committedBytes;
+        res.fragmented = (std::uint64_t)native.fragmentedBytes;
+        res.totalAllocated = (std::uint64_t)native.totalAllocatedBytes;
+        res.collections[0] = (std::uint64_t)native.gen0Collections;
+        res.collections[1] = (std::uint64_t)native.gen1Collections;
+        res.collections[2] = (std::uint64_t)native.gen2Collections;
+        res.totalPause = std::chrono::nanoseconds(native.totalPauseNanoseconds);
+        res.lastPause = std::chrono::nanoseconds(native.lastPauseNanoseconds);
+        res.pauseTimePercentage = native.pauseTimePercentage;
+        return res;
+    }
+
+    void SetGcLatencyMode(GcLatencyMode mode)
+    {
+        HandleErrorCode(gc_set_latency_mode((std::int32_t)mode));
+    }
+
+    void SetHeapHardLimit(size_t bytes)
+    {
+        HandleErrorCode(gc_set_heap_hard_limit((std::uint64_t)bytes));
+    }
+
+    void CollectGarbage(bool compact)
+    {
+        HandleErrorCode(gc_collect(compact ? 1 : 0));
+    }
+
+    GcBatchScope::GcBatchScope(GcLatencyMode mode)
+        : previous(GetGarbageCollectorInfo().latencyMode)
+    {
+        SetGcLatencyMode(mode);
+    }
+
+    GcBatchScope::~GcBatchScope()
+    {
+        // errors cannot leave a destructor, the scope is best effort
+        try
+        {
+            SetGcLatencyMode(previous);
+            CollectGarbage(true);
+        }
+        catch (...)
+        {
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace AngouriMath
+{
+    // Values of System.Runtime.GCLatencyMode
+    enum class GcLatencyMode : std::int32_t
+    {
+        // no background collections, for throughput
+        Batch = 0,
+        Interactive = 1,
+        LowLatency = 2,
+        // avoids blocking gen 2 collections while it is set
+        SustainedLowLatency = 3,
+    };
+
+    // Read by the runtime when it starts, see ConfigureGarbageCollector
+    struct GarbageCollectorOptions
+    {
+        // one heap and collector thread per core instead of a single one
+        bool server = false;
+        // gen 2 collections in the background
+        bool concurrent = true;
+        // 0 to 9, higher values compact more eagerly to keep the heap small
+        int conserveMemory = 0;
+        // allocations beyond it throw AngouriMathException named System.OutOfMemoryException;
+        // 0 leaves the runtime default, can also be changed later with SetHeapHardLimit
+        size_t heapHardLimit = 0;
+    };
+
+    struct GarbageCollectorInfo
+    {
+        bool server = false;
+        bool concurrent = false;
+        GcLatencyMode latencyMode = GcLatencyMode::Interactive;
+        int conserveMemory = 0;
+        // the hard limit if one is set, otherwise the memory available to the process
+        std::uint64_t heapHardLimit = 0;
+        std::uint64_t heapSize = 0;
+        std::uint64_t committed = 0;
+        std::uint64_t fragmented = 0;
+        std::uint64_t totalAllocated = 0;
+        std::uint64_t collections[3] = { 0, 0, 0 };
+        std::chrono::nanoseconds totalPause{};
+        std::chrono::nanoseconds lastPause{};
+        double pauseTimePercentage = 0.0;
+    };
+
+    // Sets the environment the runtime reads its collector mode from and starts it.
+    // Must be called before anything else of the library, since the runtime starts on
+    // the first call; returns false if it was already started with other settings.
+    bool ConfigureGarbageCollector(const GarbageCollectorOptions& options);
+    GarbageCollectorInfo GetGarbageCollectorInfo();
+    void SetGcLatencyMode(GcLatencyMode mode);
+    void SetHeapHardLimit(size_t bytes);
+    // Full blocking collection; a compacting one also compacts the large object heap
+    // and returns the freed memory to the OS
+    void CollectGarbage(bool compact = true);
+
+    // Runs a batch in the given latency mode and afterwards restores the previous one and
+    // compacts the heap. Declare it before the entities of the batch, so their handles
+    // are released by the time it collects.
+    class GcBatchScope
+    {
+    public:
+        explicit GcBatchScope(GcLatencyMode mode = GcLatencyMode::Batch);
+        ~GcBatchScope();
+        GcBatchScope(const GcBatchScope&) = delete;
+        GcBatchScope& operator=(const GcBatchScope&) = delete;
+
+    private:
+        GcLatencyMode previous;
+    };
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "GridEvaluation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        constexpr size_t MaxGridDims = 3;
+
+        struct Grid
+        {
+            size_t dims;
+            GridRange ranges[MaxGridDims];
+            size_t counts[MaxGridDims];
+
+            size_t Points() const
+            {
+                size_t res = 1;
+                for (size_t d = 0; d < dims; d++)
+                    res *= counts[d];
+                return res;
+            }
+
+            double Coordinate(size_t d, size_t i) const
+            {
+                if (counts[d] == 1)
+                    return ranges[d].from;
+                return ranges[d].from + (ranges[d].to - ranges[d].from) * (double)i / (double)(counts[d] - 1);
+            }
+        };
+
+        void EvaluateTile(const CompiledFunction& function, const Grid& grid, size_t begin, size_t end, float* out, std::uint8_t* invalid)
+        {
+            const size_t count = end - begin;
+            thread_local std::vector<double> args;
+            thread_local std::vector<double> values;
+            args.resize(count * grid.dims);
+            values.resize(count);
+
+            // the first dimension varies fastest
+            size_t index[MaxGridDims];
+            size_t rest = begin;
+            for (size_t d = 0; d < grid.dims; d++)
+            {
+                index[d] = rest % grid.counts[d];
+                rest /= grid.counts[d];
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                for (size_t d = 0; d < grid.dims; d++)
+                    args[i * grid.dims + d] = grid.Coordinate(d, index[d]);
+                for (size_t d = 0; d < grid.dims && ++index[d] == grid.counts[d]; d++)
+                    index[d] = 0;
+            }
+
+            function.EvaluateMany(args.data(), count, values.data());
+
+            for (size_t i = 0; i < count; i++)
+                out[begin + i] = (float)values[i];
+            if (invalid == nullptr)
+                return;
+            // tiles start at multiples of 8, so no byte is shared between threads
+            std::fill(invalid + begin / 8, invalid + (end + 7) / 8, std::uint8_t(0));
+            for (size_t i = 0; i < count; i++)
+                if (!std::isfinite(values[i]))
+                    invalid[(begin + i) / 8] |= std::uint8_t(1u << ((begin + i) % 8));
+        }
+
+        bool EvaluateGrid(const CompiledFunction& function, const Grid& grid, float* out, const GridOptions& options)
+        {
+            assert(function.VarCount() == grid.dims && function.OutputCount() == 1);
+            const size_t points = grid.Points();
+            const size_t tileSize = (std::max<size_t>(options.tileSize, 1) + 7) / 8 * 8;
+            const size_t tiles = (points + tileSize - 1) / tileSize;
+            unsigned threadCount = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            threadCount = (unsigned)std::min<size_t>(threadCount, tiles);
+
+            std::atomic<size_t> nextTile{ 0 };
+            std::atomic<bool> cancelled{ false };
+            auto work = [&]()
+            {
+                for (size_t tile = nextTile++; tile < tiles; tile = nextTile++)
+                {
+                    if (options.cancel != nullptr && options.cancel->load(std::memory_order_relaxed))
+                    {
+                        cancelled = true;
+                        return;
+                    }
+                    const size_t begin = tile * tileSize;
+                    EvaluateTile(function, grid, begin, std::min(begin + tileSize, points), out, options.invalid);
+                }
+            };
+            std::vector<std::thread> threads;
+            for (unsigned thread = 1; thread < threadCount; thread++)
+                threads.emplace_back(work);
+            work();
+            for (auto& thread : threads)
+                thread.join();
+            return !cancelled;
+        }
+    }
+
+    bool EvaluateGrid(const CompiledFunction& function, GridRange x, GridRange y, size_t nx, size_t ny, float* out, const GridOptions& options)
+    {
+        Internal::Grid grid{ 2, { x, y }, { nx, ny } };
+        return Internal::EvaluateGrid(function, grid, out, options);
+    }
+
+    bool EvaluateGrid(const CompiledFunction& function, GridRange x, GridRange y, GridRange z, size_t nx, size_t ny, size_t nz, float* out, const GridOptions& options)
+    {
+        Internal::Grid grid{ 3, { x, y, z }, { nx, ny, nz } };
+        return Internal::EvaluateGrid(function, grid, out, options);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CompiledFunction.h"
+#include <atomic>
+#include <cstdint>
+
+namespace AngouriMath
+{
+    // n points of a grid axis are from + i * (to - from) / (n - 1), both ends included
+    struct GridRange
+    {
+        double from;
+        double to;
+    };
+
+    struct GridOptions
+    {
+        // 0 uses all the hardware threads
+        unsigned threads = 0;
+        // points per tile, rounded up to a multiple of 8
+        size_t tileSize = 4096;
+        // if not null, bit i (least significant first) is set where the i-th point is a pole or NaN;
+        // must fit (points + 7) / 8 bytes
+        std::uint8_t* invalid = nullptr;
+        // checked before every tile, setting it stops the evaluation
+        const std::atomic<bool>* cancel = nullptr;
+    };
+
+    // Evaluates the function of (x, y) over the grid into the row-major ny x nx buffer,
+    // x varies fastest. The grid is cut into tiles of consecutive points which the
+    // threads take one by one. Returns false if cancelled, then out is partially written.
+    bool EvaluateGrid(const CompiledFunction& function, GridRange x, GridRange y, size_t nx, size_t ny, float* out, const GridOptions& options = {});
+    // Same for (x, y, z) into the nz x ny x nx buffer
+    bool EvaluateGrid(const CompiledFunction& function, GridRange x, GridRange y, GridRange z, size_t nx, size_t ny, size_t nz, float* out, const GridOptions& options = {});
+}
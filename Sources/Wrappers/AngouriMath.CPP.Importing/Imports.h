@@ -6,42 +6,88 @@ using namespace AngouriMath::Internal;
 
 extern "C"
 {
-# if defined(_MSC_VER) && !defined(__clang__) // clang on MSVC is a thing
+# if defined(_MSC_VER) && !defined(__clang__) && !defined(ANGOURIMATH_STATIC) // clang on MSVC is a thing
 #  define DLL_CODE __declspec(dllimport)
 # else
 #  define DLL_CODE // nothing, you don't need it
 # endif
     DLL_CODE NativeErrorCode free_entity(EntityRef);
     DLL_CODE NativeErrorCode free_native_array(NativeArray);
+    DLL_CODE NativeErrorCode free_native_buffer(NativeBuffer);
     DLL_CODE NativeErrorCode free_error_code(NativeErrorCode);
     DLL_CODE NativeErrorCode free_string(String);
+    DLL_CODE NativeErrorCode free_cursor(CursorRef);
+
+    DLL_CODE NativeErrorCode startup_runtime();
+    DLL_CODE NativeErrorCode startup_settings();
+    DLL_CODE NativeErrorCode startup_parser();
+    DLL_CODE NativeErrorCode startup_simplifier();
+
+    DLL_CODE NativeErrorCode settings_fingerprint(uint64_t*);
+    DLL_CODE NativeErrorCode settings_get(NativeSettings*);
+    DLL_CODE NativeErrorCode settings_push(const NativeSettings*, int32_t*);
+    DLL_CODE NativeErrorCode settings_pop(int32_t);
+
+    DLL_CODE NativeErrorCode gc_info(NativeGcInfo*);
+    DLL_CODE NativeErrorCode gc_set_latency_mode(int32_t);
+    DLL_CODE NativeErrorCode gc_set_heap_hard_limit(uint64_t);
+    DLL_CODE NativeErrorCode gc_collect(NativeBool compact);
+
+    DLL_CODE NativeErrorCode tracing_set_sink(TraceSink);
 
     DLL_CODE NativeErrorCode entity_to_string(EntityRef, StringOut);
     DLL_CODE NativeErrorCode entity_latexise(EntityRef, StringOut);
     DLL_CODE NativeErrorCode maths_from_string(String, EntityOut);
+    DLL_CODE NativeErrorCode maths_build_parsed(String source, NativeBuffer program, NativeBool implicitOperators, EntityOut);
 
     DLL_CODE NativeErrorCode entity_differentiate(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_integrate(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_solve(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_solve_equation(EntityRef, EntityRef, EntityOut);
+    DLL_CODE NativeErrorCode entity_solve_equations_numeric(NativeArray, EntityRef, NativeBuffer*, NativeBuffer*);
     DLL_CODE NativeErrorCode entity_integrate(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_limit(EntityRef, EntityRef, EntityRef, ApproachFrom, EntityOut);
     DLL_CODE NativeErrorCode entity_alternate(EntityRef, NativeArray*);
+    DLL_CODE NativeErrorCode entity_alternate_cursor(EntityRef, CursorRef*);
     DLL_CODE NativeErrorCode entity_simplify(EntityRef, EntityOut);
+    DLL_CODE NativeErrorCode entity_simplify_with(EntityRef, int32_t level, int32_t maxAlternatives, int32_t maxNodes, NativeSimplifyReport*, EntityOut);
+    DLL_CODE NativeErrorCode entity_simplify_incremental(EntityRef, int32_t level, int32_t window, NativeIncrementalReport*, EntityOut);
+    DLL_CODE NativeErrorCode incremental_simplifier_clear();
+    DLL_CODE NativeErrorCode entity_substitute(EntityRef, EntityRef, EntityRef, EntityOut);
+    DLL_CODE NativeErrorCode entity_substitute_vars(EntityRef, NativeArray, NativeArray, EntityOut);
+    DLL_CODE NativeErrorCode entity_replace_node(EntityRef, EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_evaled(EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_inner_simplified(EntityRef, EntityOut);
     DLL_CODE NativeErrorCode entity_to_long(EntityRef, int64_t*);
     DLL_CODE NativeErrorCode entity_to_rational(EntityRef, LongTuple*);
     DLL_CODE NativeErrorCode entity_to_double(EntityRef, double*);
     DLL_CODE NativeErrorCode entity_to_complex(EntityRef, DoubleTuple*);
+    DLL_CODE NativeErrorCode entity_substitute_many(EntityRef, NativeArray, const double*, int32_t, DoubleTuple*, uint8_t*);
+    DLL_CODE NativeErrorCode entity_substitute_grid(EntityRef, NativeArray, const double*, const int32_t*, DoubleTuple*, uint8_t*);
+    DLL_CODE NativeErrorCode entity_compile_fused(NativeArray, NativeArray, NativeBuffer*);
+    DLL_CODE NativeErrorCode entity_compile_boolean(EntityRef, NativeArray, NativeBuffer*);
+    DLL_CODE NativeErrorCode entity_compile_rational(EntityRef, NativeArray, NativeBuffer*, NativeBuffer*);
+    DLL_CODE NativeErrorCode entity_evaluate_rational(EntityRef, NativeArray, const LongTuple*, int32_t, LongTuple*, uint8_t*);
+    DLL_CODE NativeErrorCode entity_as_polynomial(EntityRef, EntityRef, NativeBuffer*);
+    DLL_CODE NativeErrorCode entity_taylor(EntityRef, EntityRef, double, int32_t, NativeBuffer*, NativeBuffer*);
+    DLL_CODE NativeErrorCode equation_system_solve(NativeArray, NativeArray, int32_t*, NativeArray*);
+
+    DLL_CODE NativeErrorCode matrix_from_buffer(const double*, int32_t, int32_t, NativeBool, EntityOut);
+    DLL_CODE NativeErrorCode matrix_shape(EntityRef, int32_t*, int32_t*);
+    DLL_CODE NativeErrorCode matrix_to_buffer(EntityRef, NativeBool, double*);
+    DLL_CODE NativeErrorCode matrix_compile(EntityRef, NativeArray, NativeBuffer*);
 
     DLL_CODE NativeErrorCode op_entity_add(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode op_entity_sub(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode op_entity_mul(EntityRef, EntityRef, EntityOut);
     DLL_CODE NativeErrorCode op_entity_div(EntityRef, EntityRef, EntityOut);
+    DLL_CODE NativeErrorCode op_entity_equal(EntityRef, EntityRef, NativeBool*);
 
     DLL_CODE NativeErrorCode entity_nodes(EntityRef, NativeArray*);
+    DLL_CODE NativeErrorCode entity_nodes_cursor(EntityRef, CursorRef*);
+    DLL_CODE NativeErrorCode cursor_next_page(CursorRef, int32_t maxCount, NativeArray*);
     DLL_CODE NativeErrorCode entity_vars(EntityRef, NativeArray*);
     DLL_CODE NativeErrorCode entity_vars_and_constants(EntityRef, NativeArray*);
     DLL_CODE NativeErrorCode entity_direct_children(EntityRef, NativeArray*);
+    DLL_CODE NativeErrorCode entity_structural_hash(EntityRef, uint64_t*);
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "CompiledFunction.h"
+
+#if defined(ANGOURIMATH_JIT_COMPILER) && !defined(_WIN32)
+#define ANGOURIMATH_JIT_AVAILABLE
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace AngouriMath
+{
+#ifdef ANGOURIMATH_JIT_AVAILABLE
+    namespace Internal
+    {
+        // FNV-1a, the source fully determines the compiled library
+        std::string SourceKey(const std::string& source)
+        {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : source)
+            {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            char buff[17];
+            std::snprintf(buff, sizeof(buff), "%016llx", (unsigned long long)hash);
+            return buff;
+        }
+
+        std::filesystem::path JitCacheDirectory(const std::string& requested)
+        {
+            if (!requested.empty())
+                return requested;
+            if (auto env = std::getenv("ANGOURIMATH_JIT_CACHE"))
+                return env;
+            if (auto xdg = std::getenv("XDG_CACHE_HOME"))
+                return std::filesystem::path(xdg) / "angourimath-jit";
+            if (auto home = std::getenv("HOME"))
+                return std::filesystem::path(home) / ".cache" / "angourimath-jit";
+            // the temp directory is shared, so the fallback is per user
+            return std::filesystem::temp_directory_path() / ("angourimath-jit-" + std::to_string(geteuid()));
+        }
+
+        // the cache holds code we are about to load, so nobody but us may be able to write to it
+        bool IsPrivateDirectory(const std::filesystem::path& directory)
+        {
+            struct stat info;
+            return lstat(directory.c_str(), &info) == 0 && S_ISDIR(info.st_mode)
+                && info.st_uid == geteuid() && (info.st_mode & 077) == 0;
+        }
+
+        bool IsTrustedLibrary(const std::filesystem::path& library)
+        {
+            struct stat info;
+            return lstat(library.c_str(), &info) == 0 && S_ISREG(info.st_mode)
+                && info.st_uid == geteuid() && (info.st_mode & 022) == 0;
+        }
+
+        bool CreatePrivateDirectory(const std::filesystem::path& directory)
+        {
+            std::error_code ec;
+            if (directory.has_parent_path())
+                std::filesystem::create_directories(directory.parent_path(), ec);
+            if (ec || (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST))
+                return false;
+            return IsPrivateDirectory(directory);
+        }
+
+        // runs the compiler directly, without a shell interpreting the paths
+        bool RunCompiler(const std::string& output, const std::string& source)
+        {
+            std::vector<std::string> args = { ANGOURIMATH_JIT_COMPILER, "-O2", "-shared", "-fPIC", "-o", output, source, "-lm" };
+            std::vector<char*> argv;
+            for (auto& arg : args)
+                argv.push_back(arg.data());
+            argv.push_back(nullptr);
+            auto pid = fork();
+            if (pid < 0)
+                return false;
+            if (pid == 0)
+            {
+                execvp(argv[0], argv.data());
+                _exit(127);
+            }
+            int status;
+            while (waitpid(pid, &status, 0) < 0)
+                if (errno != EINTR)
+                    return false;
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+
+        bool CompileLibrary(const std::string& source, const std::filesystem::path& library)
+        {
+            // the library is built under a unique name and then renamed, so that
+            // concurrent processes never load a partially written file
+            static std::atomic<unsigned> counter{ 0 };
+            auto unique = library.string() + "." + std::to_string(getpid()) + "." + std::to_string(counter++);
+            auto sourcePath = unique + ".c";
+            auto tempLibrary = unique + ".so";
+            {
+                std::ofstream file(sourcePath);
+                file << source;
+                if (!file)
+                    return false;
+            }
+            // the compiler creates the output according to umask, which may leave it group writable
+            auto compiled = RunCompiler(tempLibrary, sourcePath) && chmod(tempLibrary.c_str(), 0700) == 0;
+            std::error_code ec;
+            std::filesystem::remove(sourcePath, ec);
+            if (compiled)
+                std::filesystem::rename(tempLibrary, library, ec);
+            if (!compiled || ec)
+            {
+                std::filesystem::remove(tempLibrary, ec);
+                return false;
+            }
+            return true;
+        }
+    }
+#endif
+
+    bool CompiledFunction::Jit(const std::string& cacheDirectory)
+    {
+#ifdef ANGOURIMATH_JIT_AVAILABLE
+        if (jitted != nullptr)
+            return true;
+        constexpr const char* symbol = "angourimath_jitted";
+        auto source = EmitC(symbol);
+        std::error_code ec;
+        auto directory = Internal::JitCacheDirectory(cacheDirectory);
+        if (!Internal::CreatePrivateDirectory(directory))
+            return false;
+        auto library = directory / ("am_" + Internal::SourceKey(source + ANGOURIMATH_JIT_COMPILER) + ".so");
+        if (!std::filesystem::exists(library, ec) && !Internal::CompileLibrary(source, library))
+            return false;
+        if (!Internal::IsPrivateDirectory(directory) || !Internal::IsTrustedLibrary(library))
+            return false;
+        auto handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr)
+            return false;
+        auto function = dlsym(handle, symbol);
+        if (function == nullptr)
+        {
+            dlclose(handle);
+            return false;
+        }
+        jitLibrary = std::shared_ptr<void>(handle, [](void* h) { dlclose(h); });
+        jitted = reinterpret_cast<JitFunction>(function);
+        return true;
+#else
+        (void)cacheDirectory;
+        return false;
+#endif
+    }
+}
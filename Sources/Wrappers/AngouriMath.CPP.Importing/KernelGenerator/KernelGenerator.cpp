@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+// Reads kernel definitions, one per line, in the form of
+//     name(x, y) = x^2 + sin(y)
+// (empty lines and lines starting with # are skipped) and writes
+// a header with a standalone C++ function per kernel.
+// Used by angourimath_generate_kernels, see AngouriMathKernels.cmake.
+
+#include "AngouriMath.h"
+#include "AmgouriMathException.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    std::string Trim(const std::string& s)
+    {
+        auto begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return std::string();
+        auto end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    std::string GenerateKernel(const std::string& line)
+    {
+        auto open = line.find('(');
+        auto close = line.find(')', open);
+        auto assign = line.find('=', close);
+        if (open == std::string::npos || close == std::string::npos || assign == std::string::npos)
+            throw std::invalid_argument("Expected 'name(vars) = expression', got '" + line + "'");
+
+        std::vector<AngouriMath::Entity> vars;
+        std::istringstream varList(line.substr(open + 1, close - open - 1));
+        std::string var;
+        while (std::getline(varList, var, ','))
+            if (!Trim(var).empty())
+                vars.emplace_back(Trim(var));
+
+        AngouriMath::Entity expr = Trim(line.substr(assign + 1));
+        return expr.EmitCpp(Trim(line.substr(0, open)), vars);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <kernels file> <output header>\n";
+        return 1;
+    }
+    std::ifstream input(argv[1]);
+    if (!input)
+    {
+        std::cerr << "Cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::ostringstream header;
+    header << "#pragma once\n\n";
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(input, line); lineNumber++)
+    {
+        line = Trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        try
+        {
+            header << GenerateKernel(line) << "\n";
+        }
+        catch (const AngouriMath::AngouriMathException& e)
+        {
+            std::cerr << argv[1] << ":" << lineNumber << ": " << e.Name() << ": " << e.Message() << "\n";
+            return 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << argv[1] << ":" << lineNumber << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // only touch the header when it changes, so dependants are not rebuilt needlessly
+    // (the build rule's output is a separate stamp file)
+    {
+        std::ifstream existing(argv[2]);
+        std::stringstream existingContents;
+        existingContents << existing.rdbuf();
+        if (existing && existingContents.str() == header.str())
+            return 0;
+    }
+    std::ofstream output(argv[2]);
+    output << header.str();
+    return output ? 0 : 1;
+}
@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Parser.h"
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace AngouriMath::Internal
+{
+    namespace
+    {
+        enum class TokenKind
+        {
+            Number,
+            Variable,
+            // a name immediately followed by '(', which is a part of the token
+            Function,
+            Plus,
+            Minus,
+            Star,
+            Slash,
+            Caret,
+            Bang,
+            Comma,
+            Open,
+            Close,
+        };
+
+        struct Token
+        {
+            TokenKind kind;
+            std::int32_t start;
+            std::int32_t length;
+        };
+
+        // Literal tokens of the grammar which would otherwise be variables; the full parser
+        // handles all of them
+        constexpr const char* keywords[] = {
+            "in", "not", "and", "xor", "or", "implies", "provided", "intersect", "unite", "setsubtract",
+            "true", "True", "false", "False", "CC", "RR", "QQ", "ZZ", "BB",
+        };
+
+        struct FunctionArity
+        {
+            const char* name;
+            int min;
+            int max;
+        };
+
+        // Functions the managed side builds, with the argument counts the grammar accepts;
+        // derivative, integral, limits, domain, piecewise, apply and lambda are not here
+        constexpr FunctionArity functions[] = {
+            { "log", 1, 2 }, { "sqrt", 1, 1 }, { "cbrt", 1, 1 }, { "sqr", 1, 1 }, { "ln", 1, 1 },
+            { "sin", 1, 1 }, { "cos", 1, 1 }, { "tan", 1, 1 }, { "cotan", 1, 1 }, { "cot", 1, 1 },
+            { "sec", 1, 1 }, { "cosec", 1, 1 }, { "csc", 1, 1 },
+            { "arcsin", 1, 1 }, { "arccos", 1, 1 }, { "arctan", 1, 1 }, { "arccotan", 1, 1 },
+            { "arcsec", 1, 1 }, { "arccosec", 1, 1 }, { "arccsc", 1, 1 }, { "acsc", 1, 1 },
+            { "asin", 1, 1 }, { "acos", 1, 1 }, { "atan", 1, 1 }, { "acotan", 1, 1 }, { "asec", 1, 1 },
+            { "acosec", 1, 1 }, { "acot", 1, 1 }, { "arccot", 1, 1 },
+            { "sinh", 1, 1 }, { "sh", 1, 1 }, { "cosh", 1, 1 }, { "ch", 1, 1 }, { "tanh", 1, 1 }, { "th", 1, 1 },
+            { "cotanh", 1, 1 }, { "coth", 1, 1 }, { "cth", 1, 1 }, { "sech", 1, 1 }, { "sch", 1, 1 },
+            { "cosech", 1, 1 }, { "csch", 1, 1 },
+            { "asinh", 1, 1 }, { "arsinh", 1, 1 }, { "arsh", 1, 1 }, { "acosh", 1, 1 }, { "arcosh", 1, 1 },
+            { "arch", 1, 1 }, { "atanh", 1, 1 }, { "artanh", 1, 1 }, { "arth", 1, 1 }, { "acoth", 1, 1 },
+            { "arcoth", 1, 1 }, { "acotanh", 1, 1 }, { "arcotanh", 1, 1 }, { "arcth", 1, 1 },
+            { "asech", 1, 1 }, { "arsech", 1, 1 }, { "arsch", 1, 1 },
+            { "acosech", 1, 1 }, { "arcosech", 1, 1 }, { "arcsch", 1, 1 }, { "acsch", 1, 1 },
+            { "gamma", 1, 1 }, { "signum", 1, 1 }, { "sgn", 1, 1 }, { "sign", 1, 1 }, { "abs", 1, 1 }, { "phi", 1, 1 },
+        };
+
+        // literal tokens of the grammar which are function calls, but not of the subset
+        constexpr const char* unsupportedFunctions[] = {
+            "derivative", "integral", "limit", "limitleft", "limitright", "domain", "piecewise", "apply", "lambda",
+        };
+
+        const FunctionArity* FindFunction(std::string_view name)
+        {
+            for (const auto& function : functions)
+                if (name == function.name)
+                    return &function;
+            return nullptr;
+        }
+
+        template<size_t N>
+        bool Contains(const char* const (&words)[N], std::string_view word)
+        {
+            for (const auto* candidate : words)
+                if (word == candidate)
+                    return true;
+            return false;
+        }
+
+        bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+        bool IsLetter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+        // Same tokens as the lexer of the grammar, which takes the longest match
+        class Tokenizer
+        {
+        public:
+            explicit Tokenizer(const char* source) : source(source) { }
+
+            bool Run(std::vector<Token>& tokens)
+            {
+                while (source[position] != '\0')
+                {
+                    const char c = source[position];
+                    if (c == ' ' || c == '\t' || c == '\n')
+                    {
+                        position++;
+                        continue;
+                    }
+                    if (c == '\r' && source[position + 1] == '\n')
+                    {
+                        position += 2;
+                        continue;
+                    }
+                    if (IsDigit(c) || (c == '.' && IsDigit(source[position + 1])))
+                    {
+                        tokens.push_back(ScanNumber());
+                        continue;
+                    }
+                    if (IsLetter(c))
+                    {
+                        if (!ScanWord(tokens))
+                            return false;
+                        continue;
+                    }
+                    TokenKind kind;
+                    switch (c)
+                    {
+                    // +oo, -oo and -> are tokens of their own
+                    case '+': if (source[position + 1] == 'o' && source[position + 2] == 'o') return false; kind = TokenKind::Plus; break;
+                    case '-':
+                        if ((source[position + 1] == 'o' && source[position + 2] == 'o') || source[position + 1] == '>')
+                            return false;
+                        kind = TokenKind::Minus;
+                        break;
+                    case '*': kind = TokenKind::Star; break;
+                    // /\ is intersection, // and /* start comments
+                    case '/': if (source[position + 1] == '\\' || source[position + 1] == '/' || source[position + 1] == '*') return false; kind = TokenKind::Slash; break;
+                    case '^': kind = TokenKind::Caret; break;
+                    case '!': kind = TokenKind::Bang; break;
+                    case ',': kind = TokenKind::Comma; break;
+                    // (| opens an absolute value
+                    case '(': if (source[position + 1] == '|') return false; kind = TokenKind::Open; break;
+                    case ')': kind = TokenKind::Close; break;
+                    default: return false;
+                    }
+                    tokens.push_back({ kind, (std::int32_t)position, 1 });
+                    position++;
+                }
+                return true;
+            }
+
+        private:
+            // digits '.' digits* exponent? 'i'? | '.'? digits exponent? 'i'?
+            Token ScanNumber()
+            {
+                const auto start = position;
+                while (IsDigit(source[position]))
+                    position++;
+                if (source[position] == '.')
+                {
+                    position++;
+                    while (IsDigit(source[position]))
+                        position++;
+                }
+                if (source[position] == 'e' || source[position] == 'E')
+                {
+                    auto end = position + 1;
+                    if (source[end] == '+' || source[end] == '-')
+                        end++;
+                    if (IsDigit(source[end]))
+                    {
+                        while (IsDigit(source[end]))
+                            end++;
+                        position = end;
+                    }
+                }
+                if (source[position] == 'i')
+                    position++;
+                return { TokenKind::Number, (std::int32_t)start, (std::int32_t)(position - start) };
+            }
+
+            // letters ('_' (letters | digits)+)?, unless it is a literal of the same length,
+            // or a function literal which includes the following parenthesis
+            bool ScanWord(std::vector<Token>& tokens)
+            {
+                const auto start = position;
+                while (IsLetter(source[position]))
+                    position++;
+                const std::string_view word(source + start, position - start);
+                if (source[position] == '_' && (IsLetter(source[position + 1]) || IsDigit(source[position + 1])))
+                {
+                    position++;
+                    while (IsLetter(source[position]) || IsDigit(source[position]))
+                        position++;
+                    tokens.push_back({ TokenKind::Variable, (std::int32_t)start, (std::int32_t)(position - start) });
+                    return true;
+                }
+                if (source[position] == '(')
+                {
+                    if (FindFunction(word) != nullptr)
+                    {
+                        position++;
+                        tokens.push_back({ TokenKind::Function, (std::int32_t)start, (std::int32_t)word.size() });
+                        return true;
+                    }
+                    if (Contains(unsupportedFunctions, word))
+                        return false;
+                }
+                if (Contains(keywords, word))
+                    return false;
+                // the imaginary unit is a number, but longer words are variables
+                const auto kind = word == "i" ? TokenKind::Number : TokenKind::Variable;
+                tokens.push_back({ kind, (std::int32_t)start, (std::int32_t)word.size() });
+                return true;
+            }
+
+            const char* source;
+            size_t position = 0;
+        };
+
+        // The rules of the managed parser for omitted operators: a number, a variable or ')'
+        // followed by a variable, a function or '(' are multiplied, followed by a number,
+        // raised to its power
+        bool InsertOmittedOperators(std::vector<Token>& tokens)
+        {
+            std::vector<Token> res;
+            res.reserve(tokens.size() * 2);
+            bool inserted = false;
+            for (size_t i = 0; i < tokens.size(); i++)
+            {
+                if (i > 0)
+                {
+                    const auto left = tokens[i - 1].kind;
+                    const auto right = tokens[i].kind;
+                    if (left == TokenKind::Number || left == TokenKind::Variable || left == TokenKind::Close)
+                    {
+                        if (right == TokenKind::Variable || right == TokenKind::Function || right == TokenKind::Open)
+                        {
+                            res.push_back({ TokenKind::Star, tokens[i].start, 0 });
+                            inserted = true;
+                        }
+                        else if (right == TokenKind::Number)
+                        {
+                            res.push_back({ TokenKind::Caret, tokens[i].start, 0 });
+                            inserted = true;
+                        }
+                    }
+                }
+                res.push_back(tokens[i]);
+            }
+            tokens.swap(res);
+            return inserted;
+        }
+
+        // Recursive descent over the rules of the grammar, from sum_expression down to atom,
+        // emitting the nodes in postfix order
+        class Parser
+        {
+        public:
+            Parser(const char* source, const std::vector<Token>& tokens, std::vector<NativeParseNode>& program)
+                : source(source), tokens(tokens), program(program) { }
+
+            bool Run()
+            {
+                return Sum() && position == tokens.size();
+            }
+
+        private:
+            // deeper nesting is left to the full parser
+            static constexpr int maxDepth = 256;
+
+            bool At(TokenKind kind) const { return position < tokens.size() && tokens[position].kind == kind; }
+
+            void Emit(ParseNodeKind kind, std::int32_t start = 0, std::int32_t length = 0, std::int32_t arity = 0)
+            {
+                program.push_back({ (std::int32_t)kind, start, length, arity });
+            }
+
+            // sum_expression: mult_expression (('+' | '-') mult_expression)*
+            bool Sum()
+            {
+                if (!Mult())
+                    return false;
+                while (At(TokenKind::Plus) || At(TokenKind::Minus))
+                {
+                    const auto kind = tokens[position++].kind == TokenKind::Plus ? ParseNodeKind::Sum : ParseNodeKind::Minus;
+                    if (!Mult())
+                        return false;
+                    Emit(kind);
+                }
+                return true;
+            }
+
+            // mult_expression: unary_expression (('*' | '/') unary_expression)*
+            bool Mult()
+            {
+                if (!Unary())
+                    return false;
+                while (At(TokenKind::Star) || At(TokenKind::Slash))
+                {
+                    const auto kind = tokens[position++].kind == TokenKind::Star ? ParseNodeKind::Mul : ParseNodeKind::Div;
+                    if (!Unary())
+                        return false;
+                    Emit(kind);
+                }
+                return true;
+            }
+
+            // unary_expression: ('-' | '+') power_expression | ('-' | '+') unary_expression | power_expression;
+            // a sign followed by another sign can only be the second alternative
+            bool Unary()
+            {
+                if (!At(TokenKind::Minus) && !At(TokenKind::Plus))
+                    return Power();
+                if (++depth > maxDepth)
+                    return false;
+                const bool negate = tokens[position++].kind == TokenKind::Minus;
+                bool res;
+                if (At(TokenKind::Minus) || At(TokenKind::Plus))
+                {
+                    res = Unary();
+                    if (res && negate)
+                        Emit(ParseNodeKind::Negate);
+                }
+                else
+                {
+                    res = Power();
+                    if (res && negate)
+                        Emit(ParseNodeKind::NegateOperand);
+                }
+                depth--;
+                return res;
+            }
+
+            // power_expression: factorial_expression ('^' ...)*, right associative; both
+            // alternatives of power_list give the same tree as an exponent parsed as unary_expression
+            bool Power()
+            {
+                if (!Factorial())
+                    return false;
+                if (!At(TokenKind::Caret))
+                    return true;
+                position++;
+                if (++depth > maxDepth || !Unary())
+                    return false;
+                depth--;
+                Emit(ParseNodeKind::Pow);
+                return true;
+            }
+
+            // factorial_expression: atom '!'?
+            bool Factorial()
+            {
+                if (!Atom())
+                    return false;
+                if (At(TokenKind::Bang))
+                {
+                    position++;
+                    Emit(ParseNodeKind::Factorial);
+                }
+                return true;
+            }
+
+            bool Atom()
+            {
+                if (position == tokens.size())
+                    return false;
+                const auto& token = tokens[position++];
+                switch (token.kind)
+                {
+                case TokenKind::Number:
+                    Emit(ParseNodeKind::Number, token.start, token.length);
+                    return true;
+                case TokenKind::Variable:
+                    Emit(ParseNodeKind::Variable, token.start, token.length);
+                    return true;
+                case TokenKind::Open:
+                {
+                    if (++depth > maxDepth || !Sum() || !At(TokenKind::Close))
+                        return false;
+                    depth--;
+                    position++;
+                    return true;
+                }
+                case TokenKind::Function:
+                {
+                    if (++depth > maxDepth)
+                        return false;
+                    int arity = 0;
+                    if (!At(TokenKind::Close))
+                        do
+                        {
+                            if (!Sum())
+                                return false;
+                            arity++;
+                        } while (At(TokenKind::Comma) && ++position);
+                    if (!At(TokenKind::Close))
+                        return false;
+                    depth--;
+                    position++;
+                    const auto* function = FindFunction(std::string_view(source + token.start, token.length));
+                    // wrong argument counts are reported by the full parser
+                    if (arity < function->min || arity > function->max)
+                        return false;
+                    Emit(ParseNodeKind::Function, token.start, token.length, arity);
+                    return true;
+                }
+                default:
+                    return false;
+                }
+            }
+
+            const char* source;
+            const std::vector<Token>& tokens;
+            std::vector<NativeParseNode>& program;
+            size_t position = 0;
+            int depth = 0;
+        };
+    }
+
+    bool ParseNative(const char* source, std::vector<NativeParseNode>& program, bool& implicitOperators)
+    {
+        // token positions are int32, longer sources are left to the managed parser
+        if (std::strlen(source) > (size_t)std::numeric_limits<std::int32_t>::max())
+            return false;
+        std::vector<Token> tokens;
+        if (!Tokenizer(source).Run(tokens) || tokens.empty())
+            return false;
+        implicitOperators = InsertOmittedOperators(tokens);
+        program.clear();
+        program.reserve(tokens.size());
+        return Parser(source, tokens, program).Run();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TypeAliases.h"
+#include <vector>
+
+namespace AngouriMath::Internal
+{
+    // Kinds of NativeParseNode, each applies the action of the grammar to the values on the stack
+    enum class ParseNodeKind : std::int32_t
+    {
+        Number = 0,
+        Variable = 1,
+        Sum = 2,
+        Minus = 3,
+        Mul = 4,
+        Div = 5,
+        Pow = 6,
+        // '-' before a power expression, numbers are negated in place
+        NegateOperand = 7,
+        // '-' before another unary expression
+        Negate = 8,
+        Factorial = 9,
+        // arity arguments, the name is the text
+        Function = 10,
+    };
+
+    // Native parser of the common subset of the grammar: numbers, variables, + - * / ^ !,
+    // parentheses, calls of the elementary functions and the operators the managed parser
+    // inserts when they are omitted, as in 2x or sin(x)2. Builds the postfix program of the
+    // tree and returns true, or returns false as soon as it meets anything else, including
+    // errors, which are left to the full parser. implicitOperators tells if some operator
+    // was inserted, which is an error with explicit parsing only.
+    bool ParseNative(const char* source, std::vector<NativeParseNode>& program, bool& implicitOperators);
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Polynomial.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        template<typename T, typename X>
+        auto Horner(const T* coefficients, size_t count, X x)
+        {
+            decltype(coefficients[0] * x) res = 0.0;
+            for (size_t k = count; k-- > 0;)
+                res = res * x + coefficients[k];
+            return res;
+        }
+    }
+
+    Polynomial::Polynomial(std::vector<std::complex<double>> coefficients)
+        : coefficients(std::move(coefficients))
+    {
+        while (!this->coefficients.empty() && this->coefficients.back() == 0.0)
+            this->coefficients.pop_back();
+        if (std::all_of(this->coefficients.begin(), this->coefficients.end(), [](auto c) { return c.imag() == 0.0; }))
+            for (auto c : this->coefficients)
+                realCoefficients.push_back(c.real());
+    }
+
+    Polynomial::Polynomial(const std::vector<double>& coefficients)
+        : Polynomial(std::vector<std::complex<double>>(coefficients.begin(), coefficients.end()))
+    {
+    }
+
+    Polynomial::Polynomial(const std::vector<PolynomialTerm>& terms)
+        : Polynomial([&terms]
+            {
+                std::vector<std::complex<double>> res;
+                for (const auto& term : terms)
+                {
+                    if (res.size() <= term.power)
+                        res.resize(term.power + 1);
+                    res[term.power] += term.value;
+                }
+                return res;
+            }())
+    {
+    }
+
+    std::complex<double> Polynomial::operator()(std::complex<double> x) const
+    {
+        return Internal::Horner(coefficients.data(), coefficients.size(), x);
+    }
+
+    double Polynomial::operator()(double x) const
+    {
+        if (IsReal())
+            return Internal::Horner(realCoefficients.data(), realCoefficients.size(), x);
+        auto res = (*this)(std::complex<double>(x));
+        return res.imag() == 0.0 ? res.real() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    void Polynomial::Evaluate(const std::complex<double>* xs, size_t count, std::complex<double>* out) const
+    {
+        for (size_t i = 0; i < count; i++)
+            out[i] = (*this)(xs[i]);
+    }
+
+    void Polynomial::Evaluate(const double* xs, size_t count, double* out) const
+    {
+        if (!IsReal() || realCoefficients.empty())
+        {
+            for (size_t i = 0; i < count; i++)
+                out[i] = (*this)(xs[i]);
+            return;
+        }
+
+        // independent Horner chains over a block of points, the inner
+        // loops have a fixed trip count, so the compiler vectorises them
+        constexpr size_t lanes = 8;
+        const auto c = realCoefficients.data();
+        const auto n = realCoefficients.size();
+        size_t i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            double acc[lanes];
+            double x[lanes];
+            for (size_t j = 0; j < lanes; j++)
+            {
+                acc[j] = c[n - 1];
+                x[j] = xs[i + j];
+            }
+            for (size_t k = n - 1; k-- > 0;)
+                for (size_t j = 0; j < lanes; j++)
+                    acc[j] = acc[j] * x[j] + c[k];
+            for (size_t j = 0; j < lanes; j++)
+                out[i + j] = acc[j];
+        }
+        for (; i < count; i++)
+            out[i] = Internal::Horner(c, n, xs[i]);
+    }
+
+    Polynomial Polynomial::Derivative() const
+    {
+        std::vector<std::complex<double>> res;
+        for (size_t i = 1; i < coefficients.size(); i++)
+            res.push_back(coefficients[i] * (double)i);
+        return Polynomial(std::move(res));
+    }
+
+    std::vector<std::complex<double>> Polynomial::Roots() const
+    {
+        using Complex = std::complex<double>;
+        constexpr double Pi = 3.14159265358979323846;
+        constexpr int maxIterations = 500;
+        constexpr double tolerance = 1e-14;
+
+        std::vector<Complex> res;
+        if (coefficients.empty())
+            return res;
+
+        // x = 0 is a root of the multiplicity of the lowest non-zero power
+        size_t lowest = 0;
+        while (coefficients[lowest] == 0.0)
+            lowest++;
+        res.assign(lowest, Complex());
+        std::vector<Complex> monic(coefficients.begin() + lowest, coefficients.end());
+        const auto degree = monic.size() - 1;
+        if (degree == 0)
+            return res;
+        const auto leading = monic.back();
+        for (auto& c : monic)
+            c /= leading;
+
+        // the roots are bounded by twice the largest |a_k|^(1 / (n - k)) (Fujiwara),
+        // starting points are spread over the circle of that radius
+        double radius = 0.0;
+        for (size_t k = 0; k < degree; k++)
+            radius = std::max(radius, std::pow(std::abs(monic[k]), 1.0 / (double)(degree - k)));
+        radius *= 2;
+        std::vector<Complex> z(degree);
+        for (size_t k = 0; k < degree; k++)
+            z[k] = std::polar(radius, 2 * Pi * (double)k / (double)degree + 0.4);
+
+        const Polynomial p(monic);
+        const auto dp = p.Derivative();
+        for (int iteration = 0; iteration < maxIterations; iteration++)
+        {
+            bool converged = true;
+            for (size_t k = 0; k < degree; k++)
+            {
+                auto value = p(z[k]);
+                if (value == 0.0)
+                    continue;
+                auto slope = dp(z[k]);
+                if (slope == 0.0)
+                {
+                    // nudge off a critical point
+                    z[k] += tolerance * std::max(1.0, std::abs(z[k]));
+                    converged = false;
+                    continue;
+                }
+                auto ratio = value / slope;
+                Complex repulsion = 0.0;
+                for (size_t j = 0; j < degree; j++)
+                    if (j != k && z[j] != z[k])
+                        repulsion += 1.0 / (z[k] - z[j]);
+                auto step = ratio / (1.0 - ratio * repulsion);
+                z[k] -= step;
+                if (std::abs(step) > tolerance * std::max(1.0, std::abs(z[k])))
+                    converged = false;
+            }
+            if (converged)
+                break;
+        }
+        res.insert(res.end(), z.begin(), z.end());
+        return res;
+    }
+
+    std::vector<std::vector<std::complex<double>>> PolynomialRoots(const std::vector<Polynomial>& polynomials)
+    {
+        constexpr size_t minPerThread = 64;
+        std::vector<std::vector<std::complex<double>>> res(polynomials.size());
+        const size_t threadCount = std::min<size_t>(
+            std::max(1u, std::thread::hardware_concurrency()),
+            (polynomials.size() + minPerThread - 1) / minPerThread);
+        auto work = [&](size_t thread)
+        {
+            for (size_t i = thread; i < polynomials.size(); i += threadCount)
+                res[i] = polynomials[i].Roots();
+        };
+        if (threadCount <= 1)
+        {
+            work(0);
+            return res;
+        }
+        std::vector<std::thread> threads;
+        for (size_t thread = 1; thread < threadCount; thread++)
+            threads.emplace_back(work, thread);
+        work(0);
+        for (auto& thread : threads)
+            thread.join();
+        return res;
+    }
+
+    std::optional<double> TaylorSurrogate::TryEvaluate(double x) const
+    {
+        if (!Contains(x))
+            return std::nullopt;
+        return (*this)(x);
+    }
+
+    size_t TaylorSurrogate::Evaluate(const double* xs, size_t count, double* out, std::uint8_t* outside) const
+    {
+        size_t res = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            // shifted in place, the polynomial is then evaluated over the whole block
+            out[i] = xs[i] - point;
+            const bool isOutside = !(std::abs(out[i]) <= radius);
+            res += isOutside;
+            if (outside != nullptr)
+                outside[i] = isOutside;
+        }
+        terms.Evaluate(out, count, out);
+        return res;
+    }
+}
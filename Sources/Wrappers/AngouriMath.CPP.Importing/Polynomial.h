@@ -0,0 +1,91 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace AngouriMath
+{
+    // Non-zero coefficient of a polynomial in the exact and the floating form
+    struct PolynomialTerm
+    {
+        std::uint32_t power;
+        std::complex<double> value;
+        // set if the coefficient is a rational which fits into 64 bits
+        bool isRational;
+        std::int64_t numerator;
+        std::int64_t denominator;
+    };
+
+    // Dense polynomial in one variable, evaluated natively by Horner's scheme
+    class Polynomial
+    {
+    public:
+        Polynomial() = default;
+        // coefficients[i] is the coefficient of x^i
+        explicit Polynomial(std::vector<std::complex<double>> coefficients);
+        explicit Polynomial(const std::vector<double>& coefficients);
+        explicit Polynomial(const std::vector<PolynomialTerm>& terms);
+
+        // Degree of the zero polynomial is 0
+        size_t Degree() const { return coefficients.empty() ? 0 : coefficients.size() - 1; }
+        const std::vector<std::complex<double>>& Coefficients() const { return coefficients; }
+        bool IsReal() const { return realCoefficients.size() == coefficients.size(); }
+
+        std::complex<double> operator()(std::complex<double> x) const;
+        // NaN if the value is not real
+        double operator()(double x) const;
+
+        // Evaluates count points, xs and out may be the same buffer;
+        // the real overload is vectorised over the points
+        void Evaluate(const std::complex<double>* xs, size_t count, std::complex<double>* out) const;
+        void Evaluate(const double* xs, size_t count, double* out) const;
+
+        Polynomial Derivative() const;
+
+        // All the complex roots with multiplicity (Aberth-Ehrlich iteration)
+        std::vector<std::complex<double>> Roots() const;
+
+    private:
+        std::vector<std::complex<double>> coefficients;
+        // same as coefficients when all of them are real, empty otherwise
+        std::vector<double> realCoefficients;
+    };
+
+    // Truncated Taylor series of a real function around a point, used as a cheap
+    // surrogate inside the region |x - point| <= radius, see Entity::CompileTaylor
+    class TaylorSurrogate
+    {
+    public:
+        TaylorSurrogate() = default;
+        // terms is the polynomial in powers of (x - point)
+        TaylorSurrogate(Polynomial terms, double point, double radius, double errorBound)
+            : terms(std::move(terms)), point(point), radius(radius), errorBound(errorBound) { }
+
+        const Polynomial& Terms() const { return terms; }
+        double Point() const { return point; }
+        double Radius() const { return radius; }
+        // Estimated bound of the truncation error inside the region,
+        // infinity if the function is not finite somewhere there
+        double ErrorBound() const { return errorBound; }
+        bool Contains(double x) const { return std::abs(x - point) <= radius; }
+
+        // Extrapolates outside the region
+        double operator()(double x) const { return terms(x - point); }
+        // Empty outside the region
+        std::optional<double> TryEvaluate(double x) const;
+        // Sets outside[i] (if not null) for the points out of the region and returns their number
+        size_t Evaluate(const double* xs, size_t count, double* out, std::uint8_t* outside = nullptr) const;
+
+    private:
+        Polynomial terms;
+        double point = 0.0;
+        double radius = 0.0;
+        double errorBound = 0.0;
+    };
+
+    // The i-th vector holds the roots of the i-th polynomial,
+    // large batches are split over the hardware threads
+    std::vector<std::vector<std::complex<double>>> PolynomialRoots(const std::vector<Polynomial>& polynomials);
+}
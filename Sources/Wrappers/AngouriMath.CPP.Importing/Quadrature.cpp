@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Quadrature.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <thread>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        // Kronrod nodes, the odd ones are the 7-point Gauss nodes
+        constexpr double KronrodNodes[8] = {
+            0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+            0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+            0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+            0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+        };
+        constexpr double KronrodWeights[8] = {
+            0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+            0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+            0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+            0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+        };
+        constexpr double GaussWeights[4] = {
+            0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+            0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+        };
+        constexpr size_t PanelSize = 15;
+
+        struct Panel
+        {
+            double a;
+            double b;
+            double value;
+            double error;
+
+            bool operator<(const Panel& other) const { return error < other.error; }
+        };
+
+        Panel EvaluatePanel(const CompiledFunction& integrand, double a, double b)
+        {
+            const double center = (a + b) / 2;
+            const double half = (b - a) / 2;
+            double xs[PanelSize];
+            double fs[PanelSize];
+            for (size_t j = 0; j < 7; j++)
+            {
+                xs[2 * j] = center - half * KronrodNodes[j];
+                xs[2 * j + 1] = center + half * KronrodNodes[j];
+            }
+            xs[14] = center;
+            integrand.EvaluateMany(xs, PanelSize, fs);
+
+            double kronrod = KronrodWeights[7] * fs[14];
+            double gauss = GaussWeights[3] * fs[14];
+            for (size_t j = 0; j < 7; j++)
+            {
+                const double pair = fs[2 * j] + fs[2 * j + 1];
+                kronrod += KronrodWeights[j] * pair;
+                if (j % 2 == 1)
+                    gauss += GaussWeights[j / 2] * pair;
+            }
+            return Panel{ a, b, kronrod * half, std::abs((kronrod - gauss) * half) };
+        }
+
+        // Splits the panel with the largest error until the total error is within tolerance
+        IntegrationResult Adaptive(const CompiledFunction& integrand, double a, double b, double tolerance, size_t maxSubdivisions)
+        {
+            IntegrationResult res;
+            std::priority_queue<Panel> panels;
+            auto first = EvaluatePanel(integrand, a, b);
+            res.evaluations = PanelSize;
+            double value = first.value;
+            double error = first.error;
+            panels.push(first);
+            size_t subdivisions = 0;
+            while (std::isfinite(error) && error > tolerance && subdivisions < maxSubdivisions)
+            {
+                auto worst = panels.top();
+                panels.pop();
+                const double middle = (worst.a + worst.b) / 2;
+                auto left = EvaluatePanel(integrand, worst.a, middle);
+                auto right = EvaluatePanel(integrand, middle, worst.b);
+                res.evaluations += 2 * PanelSize;
+                value += left.value + right.value - worst.value;
+                error += left.error + right.error - worst.error;
+                panels.push(left);
+                panels.push(right);
+                subdivisions++;
+            }
+
+            // the running sums drift, so the final ones are recomputed
+            res.value = 0.0;
+            res.errorEstimate = 0.0;
+            while (!panels.empty())
+            {
+                res.value += panels.top().value;
+                res.errorEstimate += panels.top().error;
+                panels.pop();
+            }
+            res.converged = std::isfinite(res.value) && res.errorEstimate <= tolerance;
+            return res;
+        }
+
+        unsigned ThreadCount(const QuadratureOptions& options, size_t work)
+        {
+            unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            return (unsigned)std::min<size_t>(threads, std::max<size_t>(work, 1));
+        }
+
+        template<typename Work>
+        void RunOnThreads(unsigned threadCount, Work&& work)
+        {
+            std::vector<std::thread> threads;
+            for (unsigned thread = 1; thread < threadCount; thread++)
+                threads.emplace_back(work, thread);
+            work(0);
+            for (auto& thread : threads)
+                thread.join();
+        }
+    }
+
+    IntegrationResult IntegrateNumeric(const CompiledFunction& integrand, double a, double b, const QuadratureOptions& options)
+    {
+        assert(integrand.VarCount() == 1 && integrand.OutputCount() == 1);
+        if (!std::isfinite(a) || !std::isfinite(b))
+        {
+            IntegrationResult res;
+            res.value = res.errorEstimate = std::numeric_limits<double>::quiet_NaN();
+            res.converged = false;
+            return res;
+        }
+
+        // smooth integrands often need no subdivision at all, then no thread is started
+        auto whole = Internal::EvaluatePanel(integrand, a, b);
+        if (std::isfinite(whole.value) && whole.error <= options.tolerance)
+            return IntegrationResult{ whole.value, whole.error, true, Internal::PanelSize };
+
+        // every thread integrates an equal piece with a proportional share of the tolerance
+        const auto threadCount = Internal::ThreadCount(options, std::numeric_limits<size_t>::max());
+        std::vector<IntegrationResult> pieces(threadCount);
+        const double width = (b - a) / threadCount;
+        Internal::RunOnThreads(threadCount, [&](unsigned thread)
+        {
+            const double from = a + width * thread;
+            const double to = thread + 1 == threadCount ? b : from + width;
+            pieces[thread] = Internal::Adaptive(integrand, from, to, options.tolerance / threadCount, options.maxSubdivisions);
+        });
+
+        IntegrationResult res;
+        res.evaluations = Internal::PanelSize;
+        for (const auto& piece : pieces)
+        {
+            res.value += piece.value;
+            res.errorEstimate += piece.errorEstimate;
+            res.converged = res.converged && piece.converged;
+            res.evaluations += piece.evaluations;
+        }
+        return res;
+    }
+
+    std::vector<IntegrationResult> IntegrateNumeric(const CompiledFunction& integrand, const std::vector<std::pair<double, double>>& intervals, const QuadratureOptions& options)
+    {
+        std::vector<IntegrationResult> res(intervals.size());
+        QuadratureOptions single = options;
+        single.threads = 1;
+        const auto threadCount = Internal::ThreadCount(options, intervals.size());
+        Internal::RunOnThreads(threadCount, [&](unsigned thread)
+        {
+            for (size_t i = thread; i < intervals.size(); i += threadCount)
+                res[i] = IntegrateNumeric(integrand, intervals[i].first, intervals[i].second, single);
+        });
+        return res;
+    }
+}
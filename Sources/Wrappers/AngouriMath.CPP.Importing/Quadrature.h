@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CompiledFunction.h"
+#include <utility>
+#include <vector>
+
+namespace AngouriMath
+{
+    struct IntegrationResult
+    {
+        double value = 0.0;
+        double errorEstimate = 0.0;
+        // false if the tolerance was not reached within the subdivision limit
+        // or the integrand is not finite somewhere in the interval
+        bool converged = true;
+        size_t evaluations = 0;
+    };
+
+    struct QuadratureOptions
+    {
+        // absolute tolerance of the whole integral
+        double tolerance = 1e-10;
+        // per thread, subintervals beyond it are not split any further
+        size_t maxSubdivisions = 2000;
+        // 0 uses all the hardware threads
+        unsigned threads = 0;
+    };
+
+    // Adaptive 7-15 Gauss-Kronrod quadrature of the real integrand of one variable over
+    // the finite interval [a, b]. The interval is split between the threads, every
+    // 15-point panel is evaluated in one CompiledFunction::EvaluateMany call.
+    IntegrationResult IntegrateNumeric(const CompiledFunction& integrand, double a, double b, const QuadratureOptions& options = {});
+    // One result per interval, the intervals are distributed between the threads
+    std::vector<IntegrationResult> IntegrateNumeric(const CompiledFunction& integrand, const std::vector<std::pair<double, double>>& intervals, const QuadratureOptions& options = {});
+}
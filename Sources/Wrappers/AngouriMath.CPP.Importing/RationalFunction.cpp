@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "RationalFunction.h"
+#include "AngouriMath.h"
+#include "Imports.h"
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        // Values never hold INT64_MIN, so negation and abs are always defined
+        constexpr std::int64_t MinValue = std::numeric_limits<std::int64_t>::min();
+
+        enum class Outcome
+        {
+            Ok,
+            // overflow or an operation only the managed arithmetic can do exactly
+            Fallback,
+            Undefined,
+        };
+
+        inline bool Multiply(std::int64_t a, std::int64_t b, std::int64_t& res)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(a, b, &res) && res != MinValue;
+#else
+            const auto ua = a < 0 ? 0 - (std::uint64_t)a : (std::uint64_t)a;
+            const auto ub = b < 0 ? 0 - (std::uint64_t)b : (std::uint64_t)b;
+            if (ua != 0 && ub > (std::uint64_t)std::numeric_limits<std::int64_t>::max() / ua)
+                return false;
+            res = a * b;
+            return true;
+#endif
+        }
+
+        inline Rational Zero() { return Rational{ 0, 1 }; }
+
+        Outcome Normalize(Rational& value)
+        {
+            if (value.denominator == 0)
+                return Outcome::Undefined;
+            if (value.numerator == MinValue || value.denominator == MinValue)
+                return Outcome::Fallback;
+            if (value.denominator < 0)
+                value = { -value.numerator, -value.denominator };
+            const auto g = std::gcd(value.numerator, value.denominator);
+            value = { value.numerator / g, value.denominator / g };
+            return Outcome::Ok;
+        }
+
+        // Knuth's addition: with g = gcd(b, d), a/b + c/d = t / (b/g * d/g2) where
+        // t = a * d/g + c * b/g and g2 = gcd(t, g), which is already reduced
+        Outcome Add(const Rational& x, const Rational& y, Rational& res)
+        {
+            const auto g = std::gcd(x.denominator, y.denominator);
+            const auto xd = x.denominator / g;
+            const auto yd = y.denominator / g;
+#if defined(__SIZEOF_INT128__)
+            // exact, products of 64-bit values are below 2^126
+            const auto t = (__int128)x.numerator * yd + (__int128)y.numerator * xd;
+            if (t == 0)
+                return res = Zero(), Outcome::Ok;
+            const auto g2 = std::gcd((std::int64_t)(t % g), g);
+            const auto numerator = t / g2;
+            if (numerator > std::numeric_limits<std::int64_t>::max() || numerator <= MinValue)
+                return Outcome::Fallback;
+#else
+            std::int64_t left, right, numerator;
+            if (!Multiply(x.numerator, yd, left) || !Multiply(y.numerator, xd, right))
+                return Outcome::Fallback;
+            if ((right > 0 && left > std::numeric_limits<std::int64_t>::max() - right)
+                || (right < 0 && left <= MinValue - right))
+                return Outcome::Fallback;
+            numerator = left + right;
+            if (numerator == 0)
+                return res = Zero(), Outcome::Ok;
+            const auto g2 = std::gcd(numerator, g);
+            numerator /= g2;
+#endif
+            std::int64_t denominator;
+            if (!Multiply(xd, y.denominator / g2, denominator))
+                return Outcome::Fallback;
+            res = { (std::int64_t)numerator, denominator };
+            return Outcome::Ok;
+        }
+
+        // Cross-reduces before multiplying, so it only overflows if the result does not fit
+        Outcome Mul(const Rational& x, const Rational& y, Rational& res)
+        {
+            if (x.numerator == 0 || y.numerator == 0)
+                return res = Zero(), Outcome::Ok;
+            const auto g1 = std::gcd(x.numerator, y.denominator);
+            const auto g2 = std::gcd(y.numerator, x.denominator);
+            std::int64_t numerator, denominator;
+            if (!Multiply(x.numerator / g1, y.numerator / g2, numerator)
+                || !Multiply(x.denominator / g2, y.denominator / g1, denominator))
+                return Outcome::Fallback;
+            res = { numerator, denominator };
+            return Outcome::Ok;
+        }
+
+        Outcome Reciprocal(const Rational& x, Rational& res)
+        {
+            if (x.numerator == 0)
+                return Outcome::Undefined;
+            res = x.numerator < 0 ? Rational{ -x.denominator, -x.numerator } : Rational{ x.denominator, x.numerator };
+            return Outcome::Ok;
+        }
+
+        // Integer powers by squaring; the powers of coprime numbers stay coprime
+        Outcome Pow(Rational base, const Rational& exponent, Rational& res)
+        {
+            if (exponent.denominator != 1)
+                return Outcome::Fallback;
+            auto n = exponent.numerator;
+            // 0^0 and 0^-n are left to the library's own conventions
+            if (base.numerator == 0)
+                return n > 0 ? (res = Zero(), Outcome::Ok) : Outcome::Fallback;
+            if (n < 0)
+            {
+                (void)Reciprocal(base, base);
+                n = -n;
+            }
+            if (base.denominator == 1 && (base.numerator == 1 || base.numerator == -1))
+                return res = { n % 2 == 0 ? 1 : base.numerator, 1 }, Outcome::Ok;
+            // any other base overflows beyond the 63rd power
+            if (n > 63)
+                return Outcome::Fallback;
+            Rational acc{ 1, 1 };
+            while (true)
+            {
+                if (n & 1)
+                {
+                    if (!Multiply(acc.numerator, base.numerator, acc.numerator)
+                        || !Multiply(acc.denominator, base.denominator, acc.denominator))
+                        return Outcome::Fallback;
+                }
+                n >>= 1;
+                if (n == 0)
+                    break;
+                if (!Multiply(base.numerator, base.numerator, base.numerator)
+                    || !Multiply(base.denominator, base.denominator, base.denominator))
+                    return Outcome::Fallback;
+            }
+            res = acc;
+            return Outcome::Ok;
+        }
+
+        Outcome Factorial(const Rational& x, Rational& res)
+        {
+            // 20! is the last one below 2^63, negative and fractional arguments are not rational
+            if (x.denominator != 1 || x.numerator < 0 || x.numerator > 20)
+                return Outcome::Fallback;
+            std::int64_t value = 1;
+            for (std::int64_t i = 2; i <= x.numerator; i++)
+                value *= i;
+            res = { value, 1 };
+            return Outcome::Ok;
+        }
+
+        // load(k, value) fills the value of the k-th variable
+        template<typename Load>
+        Outcome RunRational(const std::vector<Instruction>& program, const std::vector<Rational>& constants, Load&& load, Rational* slots, Rational& out)
+        {
+            for (size_t i = 0; i < program.size(); i++)
+            {
+                const auto& ins = program[i];
+                auto& res = slots[i];
+                auto outcome = Outcome::Ok;
+                switch (ins.opCode)
+                {
+                case OpCode::Variable: res = load(ins.first); outcome = Normalize(res); break;
+                case OpCode::Constant: res = constants[ins.first]; break;
+                case OpCode::Output: out = slots[ins.first]; break;
+
+                case OpCode::Abs: res = { slots[ins.first].numerator < 0 ? -slots[ins.first].numerator : slots[ins.first].numerator, slots[ins.first].denominator }; break;
+                case OpCode::Signum: res = { (slots[ins.first].numerator > 0) - (slots[ins.first].numerator < 0), 1 }; break;
+                case OpCode::Factorial: outcome = Factorial(slots[ins.first], res); break;
+
+                case OpCode::Sum: outcome = Add(slots[ins.first], slots[ins.second], res); break;
+                case OpCode::Minus:
+                {
+                    const auto& y = slots[ins.second];
+                    outcome = Add(slots[ins.first], Rational{ -y.numerator, y.denominator }, res);
+                    break;
+                }
+                case OpCode::Mul: outcome = Mul(slots[ins.first], slots[ins.second], res); break;
+                case OpCode::Div:
+                {
+                    Rational reciprocal;
+                    outcome = Reciprocal(slots[ins.second], reciprocal);
+                    if (outcome == Outcome::Ok)
+                        outcome = Mul(slots[ins.first], reciprocal, res);
+                    break;
+                }
+                case OpCode::Pow: outcome = Pow(slots[ins.first], slots[ins.second], res); break;
+
+                default: assert(false && "Unknown instruction"); break;
+                }
+                if (outcome != Outcome::Ok)
+                    return outcome;
+            }
+            return Outcome::Ok;
+        }
+    }
+
+    RationalFunction::RationalFunction(std::vector<Instruction> instructions, std::vector<Rational> constants, const Entity& expression, const std::vector<Entity>& vars)
+        : instructions(std::move(instructions)), constants(std::move(constants)), varCount(vars.size()),
+          expression(std::make_shared<const Entity>(expression)), vars(std::make_shared<const std::vector<Entity>>(vars))
+    {
+    }
+
+    template<typename Load>
+    void RationalFunction::EvaluateRows(Load&& load, size_t rows, Rational* out, RationalStatus* status) const
+    {
+        std::vector<Rational> slots(instructions.size());
+        // arguments of the rows left to the managed arithmetic, as they were passed
+        std::vector<size_t> fallbackRows;
+        std::vector<Internal::LongTuple> fallbackArgs;
+        for (size_t row = 0; row < rows; row++)
+        {
+            const auto outcome = Internal::RunRational(instructions, constants, [&](std::int32_t k) { return load(row, (size_t)k); }, slots.data(), out[row]);
+            if (outcome == Internal::Outcome::Ok)
+            {
+                status[row] = RationalStatus::Exact;
+                continue;
+            }
+            out[row] = Rational{ 0, 1 };
+            status[row] = RationalStatus::Undefined;
+            if (outcome == Internal::Outcome::Undefined)
+                continue;
+            fallbackRows.push_back(row);
+            for (size_t k = 0; k < varCount; k++)
+            {
+                const auto arg = load(row, k);
+                fallbackArgs.push_back({ arg.numerator, arg.denominator });
+            }
+        }
+        if (fallbackRows.empty())
+            return;
+
+        std::vector<Internal::EntityRef> varHandles(vars->size());
+        for (size_t i = 0; i < varHandles.size(); i++)
+            varHandles[i] = GetHandle((*vars)[i]);
+        Internal::NativeArray nVars{ Internal::CheckedCount(varHandles.size(), "Variable count"), varHandles.data() };
+        std::vector<Internal::LongTuple> values(fallbackRows.size());
+        std::vector<std::uint8_t> flags(fallbackRows.size());
+        HandleErrorCode(entity_evaluate_rational(GetHandle(*expression), nVars, fallbackArgs.data(), Internal::CheckedCount(fallbackRows.size(), "Row count"), values.data(), flags.data()));
+        for (size_t i = 0; i < fallbackRows.size(); i++)
+        {
+            out[fallbackRows[i]] = Rational{ values[i].first, values[i].second };
+            status[fallbackRows[i]] = (RationalStatus)flags[i];
+        }
+    }
+
+    std::optional<Rational> RationalFunction::operator()(const std::vector<Rational>& args) const
+    {
+        assert(args.size() == varCount);
+        Rational out;
+        RationalStatus status;
+        EvaluateMany(args.data(), 1, &out, &status);
+        if (status != RationalStatus::Exact && status != RationalStatus::Managed)
+            return std::nullopt;
+        return out;
+    }
+
+    void RationalFunction::EvaluateMany(const Rational* args, size_t rows, Rational* out, RationalStatus* status) const
+    {
+        EvaluateRows([&](size_t row, size_t k) { return args[row * varCount + k]; }, rows, out, status);
+    }
+
+    void RationalFunction::EvaluateMany(const std::int64_t* args, size_t rows, Rational* out, RationalStatus* status) const
+    {
+        EvaluateRows([&](size_t row, size_t k) { return Rational{ args[row * varCount + k], 1 }; }, rows, out, status);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CompiledFunction.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace AngouriMath
+{
+    class Entity;
+
+    // Exact rational, normalized results have a positive denominator coprime with the numerator
+    struct Rational
+    {
+        std::int64_t numerator = 0;
+        std::int64_t denominator = 1;
+
+        bool operator==(const Rational& other) const { return numerator == other.numerator && denominator == other.denominator; }
+        bool operator!=(const Rational& other) const { return !(*this == other); }
+    };
+
+    enum class RationalStatus : std::uint8_t
+    {
+        // computed in native integers
+        Exact = 0,
+        // some native intermediate value overflowed, computed with arbitrary precision instead
+        Managed = 1,
+        // the value is exact, but does not fit into 64 bits
+        Overflow = 2,
+        // division by zero, or the value is not rational, as 2^(1/2)
+        Undefined = 3,
+    };
+
+    // Exact evaluator of an expression of +, -, *, /, integer powers, abs, sign and factorial
+    // over rational variables. Runs in 64-bit integers with 128-bit intermediate sums where the
+    // compiler has them and detects overflow; only the rows which overflow, or need a power
+    // with a non-integer exponent, are evaluated by the managed big-number arithmetic, in one
+    // call per batch.
+    class RationalFunction
+    {
+    public:
+        RationalFunction() = default;
+        // Constant instructions refer to constants by their first index
+        RationalFunction(std::vector<Instruction> instructions, std::vector<Rational> constants, const Entity& expression, const std::vector<Entity>& vars);
+
+        size_t VarCount() const { return varCount; }
+        const std::vector<Instruction>& Instructions() const { return instructions; }
+        const std::vector<Rational>& Constants() const { return constants; }
+
+        // nullopt unless the status is Exact or Managed
+        std::optional<Rational> operator()(const std::vector<Rational>& args) const;
+        // args is a row-major rows x VarCount() matrix; arguments need not be normalized,
+        // a zero denominator makes the row Undefined. out is zero where the status
+        // is Overflow or Undefined.
+        void EvaluateMany(const Rational* args, size_t rows, Rational* out, RationalStatus* status) const;
+        void EvaluateMany(const std::int64_t* args, size_t rows, Rational* out, RationalStatus* status) const;
+
+    private:
+        template<typename Load>
+        void EvaluateRows(Load&& load, size_t rows, Rational* out, RationalStatus* status) const;
+
+        std::vector<Instruction> instructions;
+        std::vector<Rational> constants;
+        size_t varCount = 0;
+        // for the managed fallback
+        std::shared_ptr<const Entity> expression;
+        std::shared_ptr<const std::vector<Entity>> vars;
+    };
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+// Worker process of AngouriMath::ComputeServerPool. It hosts its own runtime of the
+// exported library and serves the requests of one pool connection until it is closed.
+
+#include "ComputeServer.h"
+
+int main(int argc, char** argv)
+{
+    return AngouriMath::Internal::RunComputeServer(argc, argv);
+}
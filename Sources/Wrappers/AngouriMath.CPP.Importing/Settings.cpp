@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Settings.h"
+#include "ErrorCode.h"
+#include "Imports.h"
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        // Keep in sync with NativeSettingsMask
+        enum SettingsMask : std::int32_t
+        {
+            PrecisionErrorCommon = 1 << 0,
+            PrecisionErrorZeroRange = 1 << 1,
+            FloatToRationalIterCount = 1 << 2,
+            MaxAbsNumeratorOrDenominatorValue = 1 << 3,
+            AllowNewton = 1 << 4,
+            NewtonSolver = 1 << 5,
+            DowncastingEnabled = 1 << 6,
+            ExplicitParsingOnly = 1 << 7,
+            MaxExpansionTermCount = 1 << 8,
+        };
+
+        template<typename T, typename Field>
+        void Override(NativeSettings& native, const std::optional<T>& value, SettingsMask flag, Field& field)
+        {
+            if (!value)
+                return;
+            native.mask |= flag;
+            field = (Field)*value;
+        }
+    }
+
+    Settings CurrentSettings()
+    {
+        Internal::NativeSettings native;
+        HandleErrorCode(settings_get(&native));
+        Settings res;
+        res.precisionErrorCommon = native.precisionErrorCommon;
+        res.precisionErrorZeroRange = native.precisionErrorZeroRange;
+        res.floatToRationalIterCount = native.floatToRationalIterCount;
+        res.maxAbsNumeratorOrDenominatorValue = native.maxAbsNumeratorOrDenominatorValue;
+        res.allowNewton = native.allowNewton != 0;
+        res.newtonSolver.from = { native.newtonFromRe, native.newtonFromIm };
+        res.newtonSolver.to = { native.newtonToRe, native.newtonToIm };
+        res.newtonSolver.realSteps = native.newtonStepsRe;
+        res.newtonSolver.imaginarySteps = native.newtonStepsIm;
+        res.newtonSolver.precision = native.newtonPrecision;
+        res.downcastingEnabled = native.downcastingEnabled != 0;
+        res.explicitParsingOnly = native.explicitParsingOnly != 0;
+        res.maxExpansionTermCount = native.maxExpansionTermCount;
+        return res;
+    }
+
+    SettingsScope::SettingsScope(const SettingsOverrides& overrides)
+    {
+        using namespace Internal;
+        NativeSettings native{};
+        Override(native, overrides.precisionErrorCommon, PrecisionErrorCommon, native.precisionErrorCommon);
+        Override(native, overrides.precisionErrorZeroRange, PrecisionErrorZeroRange, native.precisionErrorZeroRange);
+        Override(native, overrides.floatToRationalIterCount, FloatToRationalIterCount, native.floatToRationalIterCount);
+        Override(native, overrides.maxAbsNumeratorOrDenominatorValue, MaxAbsNumeratorOrDenominatorValue, native.maxAbsNumeratorOrDenominatorValue);
+        Override(native, overrides.allowNewton, AllowNewton, native.allowNewton);
+        Override(native, overrides.downcastingEnabled, DowncastingEnabled, native.downcastingEnabled);
+        Override(native, overrides.explicitParsingOnly, ExplicitParsingOnly, native.explicitParsingOnly);
+        Override(native, overrides.maxExpansionTermCount, MaxExpansionTermCount, native.maxExpansionTermCount);
+        if (const auto& newton = overrides.newtonSolver)
+        {
+            native.mask |= NewtonSolver;
+            native.newtonFromRe = newton->from.real();
+            native.newtonFromIm = newton->from.imag();
+            native.newtonToRe = newton->to.real();
+            native.newtonToIm = newton->to.imag();
+            native.newtonStepsRe = newton->realSteps;
+            native.newtonStepsIm = newton->imaginarySteps;
+            native.newtonPrecision = newton->precision;
+        }
+        HandleErrorCode(settings_push(&native, &depth));
+    }
+
+    SettingsScope::~SettingsScope()
+    {
+        // errors cannot leave a destructor; the depth only mismatches if scopes were
+        // moved between threads or ended out of order
+        try
+        {
+            HandleErrorCode(settings_pop(depth));
+        }
+        catch (...)
+        {
+        }
+    }
+}
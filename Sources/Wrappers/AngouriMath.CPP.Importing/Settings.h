@@ -0,0 +1,71 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <optional>
+
+namespace AngouriMath
+{
+    // Where MathS.Settings.NewtonSolver searches for roots when no analytical solution is found
+    struct NewtonSettings
+    {
+        // corners of the rectangle of starting points
+        std::complex<double> from{ -10.0, -10.0 };
+        std::complex<double> to{ 10.0, 10.0 };
+        int realSteps = 10;
+        int imaginarySteps = 10;
+        // digits, the higher, the longer the search takes
+        int precision = 30;
+    };
+
+    // MathS.Settings of the calling thread
+    struct Settings
+    {
+        // values closer than it are equal
+        double precisionErrorCommon = 0.0;
+        // values smaller than it are zero
+        double precisionErrorZeroRange = 0.0;
+        // continued fraction steps when a float is turned into a rational
+        int floatToRationalIterCount = 0;
+        // rational approximations stop at it, INT64_MAX if the bound is larger
+        std::int64_t maxAbsNumeratorOrDenominatorValue = 0;
+        // numeric fallback of the solvers
+        bool allowNewton = false;
+        NewtonSettings newtonSolver;
+        bool downcastingEnabled = false;
+        bool explicitParsingOnly = false;
+        std::int64_t maxExpansionTermCount = 0;
+    };
+
+    // Settings a SettingsScope changes, the rest keep their current values
+    struct SettingsOverrides
+    {
+        std::optional<double> precisionErrorCommon;
+        std::optional<double> precisionErrorZeroRange;
+        std::optional<int> floatToRationalIterCount;
+        std::optional<std::int64_t> maxAbsNumeratorOrDenominatorValue;
+        std::optional<bool> allowNewton;
+        std::optional<NewtonSettings> newtonSolver;
+        std::optional<bool> downcastingEnabled;
+        std::optional<bool> explicitParsingOnly;
+        std::optional<std::int64_t> maxExpansionTermCount;
+    };
+
+    Settings CurrentSettings();
+
+    // Applies the overrides to the calling thread for its lifetime, other threads keep
+    // their own settings. Scopes nest and must end in reverse order on the thread which
+    // created them. Simplify() caches by the settings, but Evaled() and InnerSimplified()
+    // are computed once per entity, whichever scope they were first asked in.
+    class SettingsScope
+    {
+    public:
+        explicit SettingsScope(const SettingsOverrides& overrides);
+        ~SettingsScope();
+        SettingsScope(const SettingsScope&) = delete;
+        SettingsScope& operator=(const SettingsScope&) = delete;
+
+    private:
+        std::int32_t depth = 0;
+    };
+}
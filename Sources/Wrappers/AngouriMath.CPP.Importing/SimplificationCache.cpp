@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "SimplificationCache.h"
+#include <atomic>
+#include <memory>
+
+#if !defined(_WIN32)
+#define ANGOURIMATH_SIMPLIFICATION_CACHE_AVAILABLE
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+#ifdef ANGOURIMATH_SIMPLIFICATION_CACHE_AVAILABLE
+        // The file is a header followed by sets of Ways fixed-size slots, an entry lives in the
+        // set of its key. Readers take no lock: a slot is written under a sequence number, which
+        // is odd while the write is in progress, and carries a checksum of its contents, so torn
+        // or half-written slots (e. g. of a crashed process) are skipped. Writers serialize on
+        // flock, which the kernel releases when a process dies.
+        constexpr char CacheMagic[8] = { 'A', 'M', 'S', 'I', 'M', 'P', 'L', 'C' };
+        constexpr std::uint32_t CacheVersion = 1;
+        constexpr size_t CacheHeaderSize = 64;
+        constexpr size_t SlotSize = 512;
+        constexpr size_t Ways = 8;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The cache is shared between processes");
+
+        struct CacheHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t slotSize;
+            std::uint64_t slotCount;
+            std::atomic<std::uint64_t> clock;
+        };
+
+        struct CacheSlot
+        {
+            std::atomic<std::uint32_t> sequence;
+            std::uint16_t inputLength;
+            std::uint16_t outputLength;
+            std::atomic<std::uint64_t> lastUse;
+            std::uint64_t key;
+            std::uint64_t checksum;
+            char data[SlotSize - 32];
+        };
+
+        static_assert(sizeof(CacheHeader) <= CacheHeaderSize && sizeof(CacheSlot) == SlotSize);
+
+        std::uint64_t Checksum(std::uint64_t key, const char* data, size_t inputLength, size_t outputLength)
+        {
+            std::uint64_t hash = 14695981039346656037ull ^ key;
+            auto mix = [&hash](std::uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+            mix(inputLength);
+            mix(outputLength);
+            for (size_t i = 0; i < inputLength + outputLength; i++)
+                mix((unsigned char)data[i]);
+            return hash;
+        }
+
+        std::filesystem::path SimplificationCachePath(const std::string& requested)
+        {
+            if (!requested.empty())
+                return requested;
+            if (auto env = std::getenv("ANGOURIMATH_SIMPLIFY_CACHE"))
+                return env;
+            if (auto xdg = std::getenv("XDG_CACHE_HOME"))
+                return std::filesystem::path(xdg) / "angourimath-simplify.cache";
+            if (auto home = std::getenv("HOME"))
+                return std::filesystem::path(home) / ".cache" / "angourimath-simplify.cache";
+            return std::filesystem::temp_directory_path() / "angourimath-simplify.cache";
+        }
+
+        class MappedCache
+        {
+        public:
+            ~MappedCache()
+            {
+                if (mapping != nullptr)
+                    munmap(mapping, size);
+                if (fd >= 0)
+                    close(fd);
+            }
+
+            static std::shared_ptr<MappedCache> Open(const SimplificationCacheOptions& options)
+            {
+                auto path = SimplificationCachePath(options.path);
+                std::error_code ec;
+                if (path.has_parent_path())
+                    std::filesystem::create_directories(path.parent_path(), ec);
+                std::shared_ptr<MappedCache> res(new MappedCache());
+                res->fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+                if (res->fd < 0 || flock(res->fd, LOCK_EX) != 0)
+                    return nullptr;
+                bool mapped = res->Map(options.maxBytes);
+                flock(res->fd, LOCK_UN);
+                return mapped ? res : nullptr;
+            }
+
+            std::optional<std::string> Lookup(std::uint64_t key, const std::string& input)
+            {
+                auto set = Set(key);
+                for (size_t way = 0; way < Ways; way++)
+                {
+                    auto& slot = set[way];
+                    auto sequence = slot.sequence.load(std::memory_order_acquire);
+                    if (sequence == 0 || sequence % 2 == 1 || slot.key != key)
+                        continue;
+                    size_t inputLength = slot.inputLength;
+                    size_t outputLength = slot.outputLength;
+                    auto checksum = slot.checksum;
+                    if (inputLength != input.size() || inputLength + outputLength > sizeof(slot.data))
+                        continue;
+                    std::string data(slot.data, inputLength + outputLength);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.sequence.load(std::memory_order_relaxed) != sequence
+                        || Checksum(key, data.data(), inputLength, outputLength) != checksum
+                        || data.compare(0, inputLength, input) != 0)
+                        continue;
+                    slot.lastUse.store(Header().clock.fetch_add(1) + 1, std::memory_order_relaxed);
+                    hits++;
+                    return data.substr(inputLength);
+                }
+                misses++;
+                return std::nullopt;
+            }
+
+            void Store(std::uint64_t key, const std::string& input, const std::string& output)
+            {
+                if (input.size() + output.size() > sizeof(CacheSlot::data))
+                    return;
+                std::lock_guard<std::mutex> lock(writer);
+                if (flock(fd, LOCK_EX) != 0)
+                    return;
+                auto& slot = Victim(key, input);
+                auto sequence = slot.sequence.load(std::memory_order_relaxed);
+                // an odd sequence here is left by a writer which crashed, as writers are serialized
+                auto writing = sequence % 2 == 1 ? sequence : sequence + 1;
+                slot.sequence.store(writing, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                slot.key = key;
+                slot.inputLength = (std::uint16_t)input.size();
+                slot.outputLength = (std::uint16_t)output.size();
+                std::memcpy(slot.data, input.data(), input.size());
+                std::memcpy(slot.data + input.size(), output.data(), output.size());
+                slot.checksum = Checksum(key, slot.data, input.size(), output.size());
+                slot.lastUse.store(Header().clock.fetch_add(1) + 1, std::memory_order_relaxed);
+                slot.sequence.store(writing + 1, std::memory_order_release);
+                flock(fd, LOCK_UN);
+                stores++;
+            }
+
+            SimplificationCacheStats Stats() const
+            {
+                return SimplificationCacheStats{ hits.load(), misses.load(), stores.load() };
+            }
+
+        private:
+            MappedCache() = default;
+
+            CacheHeader& Header() { return *reinterpret_cast<CacheHeader*>(mapping); }
+
+            CacheSlot* Set(std::uint64_t key)
+            {
+                auto slots = reinterpret_cast<CacheSlot*>(static_cast<char*>(mapping) + CacheHeaderSize);
+                return slots + key % (slotCount / Ways) * Ways;
+            }
+
+            // same entry, then a free slot, then a crashed write, then the least recently used
+            CacheSlot& Victim(std::uint64_t key, const std::string& input)
+            {
+                auto set = Set(key);
+                CacheSlot* res = nullptr;
+                int resRank = 4;
+                for (size_t way = 0; way < Ways; way++)
+                {
+                    auto& slot = set[way];
+                    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+                    int rank = 3;
+                    if (sequence != 0 && sequence % 2 == 0 && slot.key == key && slot.inputLength == input.size()
+                        && std::memcmp(slot.data, input.data(), input.size()) == 0)
+                        rank = 0;
+                    else if (sequence == 0)
+                        rank = 1;
+                    else if (sequence % 2 == 1)
+                        rank = 2;
+                    if (rank < resRank || (rank == 3 && resRank == 3 && slot.lastUse.load() < res->lastUse.load()))
+                    {
+                        res = &slot;
+                        resRank = rank;
+                    }
+                }
+                return *res;
+            }
+
+            // called under the file lock
+            bool Map(size_t maxBytes)
+            {
+                struct stat st;
+                if (fstat(fd, &st) != 0)
+                    return false;
+                CacheHeader existing{};
+                bool valid = (size_t)st.st_size >= CacheHeaderSize
+                    && pread(fd, &existing, sizeof(existing) - sizeof(existing.clock), 0) == (ssize_t)(sizeof(existing) - sizeof(existing.clock))
+                    && std::memcmp(existing.magic, CacheMagic, sizeof(CacheMagic)) == 0
+                    && existing.version == CacheVersion
+                    && existing.slotSize == SlotSize
+                    && existing.slotCount != 0
+                    && existing.slotCount % Ways == 0
+                    && (size_t)st.st_size == CacheHeaderSize + existing.slotCount * SlotSize;
+                slotCount = valid
+                    ? existing.slotCount
+                    : (maxBytes > CacheHeaderSize ? (maxBytes - CacheHeaderSize) / SlotSize / Ways * Ways : 0);
+                if (slotCount == 0)
+                    return false;
+                size = CacheHeaderSize + slotCount * SlotSize;
+                // an invalid file is resized to exactly the new layout, otherwise a larger one
+                // would fail the size check above on every open and never be reused
+                if (!valid && (size_t)st.st_size != size && ftruncate(fd, (off_t)size) != 0)
+                    return false;
+                mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapping == MAP_FAILED)
+                {
+                    mapping = nullptr;
+                    return false;
+                }
+                if (!valid)
+                {
+                    std::memset(mapping, 0, size);
+                    auto& header = Header();
+                    header.version = CacheVersion;
+                    header.slotSize = SlotSize;
+                    header.slotCount = slotCount;
+                    std::atomic_thread_fence(std::memory_order_release);
+                    std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+                }
+                return true;
+            }
+
+            int fd = -1;
+            void* mapping = nullptr;
+            size_t size = 0;
+            size_t slotCount = 0;
+            std::mutex writer;
+            std::atomic<std::uint64_t> hits{ 0 };
+            std::atomic<std::uint64_t> misses{ 0 };
+            std::atomic<std::uint64_t> stores{ 0 };
+        };
+#else
+        class MappedCache
+        {
+        public:
+            std::optional<std::string> Lookup(std::uint64_t, const std::string&) { return std::nullopt; }
+            void Store(std::uint64_t, const std::string&, const std::string&) { }
+            SimplificationCacheStats Stats() const { return {}; }
+        };
+#endif
+
+        std::shared_ptr<MappedCache> currentCache;
+
+        std::shared_ptr<MappedCache> CurrentCache()
+        {
+            return std::atomic_load(&currentCache);
+        }
+
+        bool IsSimplificationCacheEnabled()
+        {
+            return CurrentCache() != nullptr;
+        }
+
+        std::optional<std::string> SimplificationCacheLookup(std::uint64_t key, const std::string& input)
+        {
+            auto cache = CurrentCache();
+            return cache != nullptr ? cache->Lookup(key, input) : std::nullopt;
+        }
+
+        void SimplificationCacheStore(std::uint64_t key, const std::string& input, const std::string& output)
+        {
+            if (auto cache = CurrentCache())
+                cache->Store(key, input, output);
+        }
+    }
+
+    bool EnableSimplificationCache(const SimplificationCacheOptions& options)
+    {
+#ifdef ANGOURIMATH_SIMPLIFICATION_CACHE_AVAILABLE
+        auto cache = Internal::MappedCache::Open(options);
+        if (cache == nullptr)
+            return false;
+        std::atomic_store(&Internal::currentCache, cache);
+        return true;
+#else
+        (void)options;
+        return false;
+#endif
+    }
+
+    void DisableSimplificationCache()
+    {
+        std::atomic_store(&Internal::currentCache, std::shared_ptr<Internal::MappedCache>());
+    }
+
+    SimplificationCacheStats GetSimplificationCacheStats()
+    {
+        auto cache = Internal::CurrentCache();
+        return cache != nullptr ? cache->Stats() : SimplificationCacheStats{};
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace AngouriMath
+{
+    struct SimplificationCacheOptions
+    {
+        // empty uses $ANGOURIMATH_SIMPLIFY_CACHE or angourimath-simplify.cache in the user cache directory
+        std::string path;
+        // size of the file; an existing valid file keeps the size it was created with
+        size_t maxBytes = 64u << 20;
+    };
+
+    struct SimplificationCacheStats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t stores = 0;
+    };
+
+    // Opt-in persistent cache of Entity::Simplify results, shared between the processes
+    // of the host through a memory-mapped file. Entries are keyed by the structural hash
+    // and the string form of the input and by the simplification settings of the calling
+    // thread; the least recently used entries are evicted once the file is full.
+    // Returns false if the file cannot be mapped (always on Windows).
+    bool EnableSimplificationCache(const SimplificationCacheOptions& options = {});
+    void DisableSimplificationCache();
+    // Of this process since the cache was enabled
+    SimplificationCacheStats GetSimplificationCacheStats();
+
+    namespace Internal
+    {
+        bool IsSimplificationCacheEnabled();
+        std::optional<std::string> SimplificationCacheLookup(std::uint64_t key, const std::string& input);
+        void SimplificationCacheStore(std::uint64_t key, const std::string& input, const std::string& output);
+    }
+}
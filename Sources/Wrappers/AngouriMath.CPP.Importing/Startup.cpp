@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Startup.h"
+#include "ErrorCode.h"
+#include "Imports.h"
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        template<typename Phase>
+        std::chrono::nanoseconds Measure(Phase&& phase)
+        {
+            auto start = std::chrono::steady_clock::now();
+            HandleErrorCode(phase());
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        }
+
+        WarmupTimings Warmup(const WarmupOptions& options)
+        {
+            WarmupTimings res;
+            res.runtime = Measure(startup_runtime);
+            if (options.settings)
+                res.settings = Measure(startup_settings);
+            if (options.parser)
+                res.parser = Measure(startup_parser);
+            if (options.simplifier)
+                res.simplifier = Measure(startup_simplifier);
+            return res;
+        }
+    }
+
+    std::shared_future<WarmupTimings> Initialize(const WarmupOptions& options)
+    {
+        if (options.background)
+            return std::async(std::launch::async, Internal::Warmup, options).share();
+        std::promise<WarmupTimings> res;
+        try
+        {
+            res.set_value(Internal::Warmup(options));
+        }
+        catch (...)
+        {
+            res.set_exception(std::current_exception());
+        }
+        return res.get_future().share();
+    }
+}
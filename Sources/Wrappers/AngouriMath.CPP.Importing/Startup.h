@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+
+namespace AngouriMath
+{
+    // What Initialize warms up. The runtime is always initialized.
+    struct WarmupOptions
+    {
+        // static initialization of MathS and the settings of the initializing thread
+        bool settings = true;
+        // lexer and parser tables, paid otherwise by the first parsed Entity
+        bool parser = true;
+        // simplification of a small expression
+        bool simplifier = false;
+        // runs the warm-up on a separate thread and returns immediately
+        bool background = false;
+    };
+
+    // Wall time of every phase, phases which were not run are zero
+    struct WarmupTimings
+    {
+        std::chrono::nanoseconds runtime{};
+        std::chrono::nanoseconds settings{};
+        std::chrono::nanoseconds parser{};
+        std::chrono::nanoseconds simplifier{};
+
+        std::chrono::nanoseconds Total() const { return runtime + settings + parser + simplifier; }
+    };
+
+    // Performs the one-time initialization which otherwise happens inside the first
+    // request. The future is ready on return unless options.background is set; if a
+    // phase fails, it rethrows the AngouriMathException. Safe to call more than once,
+    // later calls only measure the already warm phases.
+    std::shared_future<WarmupTimings> Initialize(const WarmupOptions& options = {});
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019-2022 Angouri.
+ * AngouriMath is licensed under MIT.
+ * Details: https://github.com/asc-community/AngouriMath/blob/master/LICENSE.md.
+ * Website: https://am.angouri.org.
+ */
+
+#include "Tracing.h"
+#include "ErrorCode.h"
+#include "Imports.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define ANGOURIMATH_GETPID _getpid
+#else
+#include <unistd.h>
+#define ANGOURIMATH_GETPID getpid
+#endif
+
+namespace AngouriMath
+{
+    namespace Internal
+    {
+        enum class TracePhase : std::uint8_t { Begin = 0, End = 1 };
+        enum class TraceCategory : std::uint8_t { Native = 0, Managed = 1 };
+
+        struct TraceEvent
+        {
+            const char* name;
+            std::uint64_t timestamp;
+            TracePhase phase;
+            TraceCategory category;
+        };
+
+        // Written only by its thread: the event is stored first and published by
+        // advancing head, so a reader sees the events in [head - capacity, head)
+        // and after copying them rechecks head to drop the ones overwritten meanwhile.
+        struct TraceRing
+        {
+            TraceRing(size_t capacity, std::uint32_t threadId)
+                : events(capacity), threadId(threadId) { }
+
+            std::vector<TraceEvent> events;
+            std::atomic<std::uint64_t> head{ 0 };
+            // events before it were cleared
+            std::atomic<std::uint64_t> tail{ 0 };
+            std::uint32_t threadId;
+        };
+
+        std::atomic<bool> tracingEnabled{ false };
+        std::atomic<size_t> ringCapacity{ TracingOptions{}.eventsPerThread };
+
+        // rings outlive their threads, so the spans of finished threads are dumped too
+        std::mutex ringsMutex;
+        std::vector<std::shared_ptr<TraceRing>> rings;
+
+        std::uint64_t Now()
+        {
+            static const auto origin = std::chrono::steady_clock::now();
+            return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - origin).count();
+        }
+
+        TraceRing& ThreadRing()
+        {
+            thread_local std::shared_ptr<TraceRing> ring;
+            if (ring == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(ringsMutex);
+                ring = std::make_shared<TraceRing>(std::max<size_t>(ringCapacity.load(), 2), (std::uint32_t)rings.size() + 1);
+                rings.push_back(ring);
+            }
+            return *ring;
+        }
+
+        void Record(const char* name, TracePhase phase, TraceCategory category)
+        {
+            auto& ring = ThreadRing();
+            auto head = ring.head.load(std::memory_order_relaxed);
+            ring.events[head % ring.events.size()] = TraceEvent{ name, Now(), phase, category };
+            ring.head.store(head + 1, std::memory_order_release);
+        }
+
+        // called by the managed exports, on the thread which called them
+        void ManagedSpan(const char* name, std::int32_t phase)
+        {
+            if (tracingEnabled.load(std::memory_order_relaxed))
+                Record(name, (TracePhase)phase, TraceCategory::Managed);
+        }
+
+        std::vector<TraceEvent> Snapshot(TraceRing& ring)
+        {
+            const auto capacity = ring.events.size();
+            const auto head = ring.head.load(std::memory_order_acquire);
+            auto from = std::max(ring.tail.load(), head > capacity ? head - capacity : 0);
+            std::vector<TraceEvent> res;
+            res.reserve((size_t)(head - from));
+            for (auto i = from; i < head; i++)
+                res.push_back(ring.events[i % capacity]);
+            // the events the writer got to in the meantime may have overwritten the oldest copied ones
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto after = ring.head.load(std::memory_order_relaxed);
+            if (after > capacity && after - capacity > from)
+                res.erase(res.begin(), res.begin() + (std::ptrdiff_t)std::min<std::uint64_t>(after - capacity - from, res.size()));
+            return res;
+        }
+
+        void WriteEscaped(std::ostream& out, const char* str)
+        {
+            for (; *str != '\0'; str++)
+            {
+                const auto c = (unsigned char)*str;
+                if (c == '"' || c == '\\')
+                    out << '\\' << (char)c;
+                else if (c < 0x20)
+                {
+                    char buff[8];
+                    std::snprintf(buff, sizeof(buff), "\\u%04x", c);
+                    out << buff;
+                }
+                else
+                    out << (char)c;
+            }
+        }
+    }
+
+    void EnableTracing(const TracingOptions& options)
+    {
+        Internal::ringCapacity = options.eventsPerThread;
+        HandleErrorCode(tracing_set_sink(options.managed ? &Internal::ManagedSpan : nullptr));
+        Internal::tracingEnabled = true;
+    }
+
+    void DisableTracing()
+    {
+        Internal::tracingEnabled = false;
+        HandleErrorCode(tracing_set_sink(nullptr));
+    }
+
+    bool IsTracingEnabled()
+    {
+        return Internal::tracingEnabled.load(std::memory_order_relaxed);
+    }
+
+    void ClearTrace()
+    {
+        std::lock_guard<std::mutex> lock(Internal::ringsMutex);
+        for (const auto& ring : Internal::rings)
+            ring->tail = ring->head.load(std::memory_order_acquire);
+    }
+
+    void WriteChromeTrace(std::ostream& out)
+    {
+        std::vector<std::shared_ptr<Internal::TraceRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(Internal::ringsMutex);
+            rings = Internal::rings;
+        }
+        const auto pid = (long)ANGOURIMATH_GETPID();
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        auto first = true;
+        for (const auto& ring : rings)
+        {
+            // a wrapped ring may start inside spans, their ends have nothing to match
+            size_t depth = 0;
+            for (const auto& event : Internal::Snapshot(*ring))
+            {
+                if (event.phase == Internal::TracePhase::End)
+                {
+                    if (depth == 0)
+                        continue;
+                    depth--;
+                }
+                else
+                    depth++;
+                char timestamp[32];
+                std::snprintf(timestamp, sizeof(timestamp), "%llu.%03llu",
+                    (unsigned long long)(event.timestamp / 1000), (unsigned long long)(event.timestamp % 1000));
+                out << (first ? "" : ",") << "\n{\"name\":\"";
+                Internal::WriteEscaped(out, event.name);
+                out << "\",\"cat\":\"" << (event.category == Internal::TraceCategory::Managed ? "managed" : "native")
+                    << "\",\"ph\":\"" << (event.phase == Internal::TracePhase::Begin ? 'B' : 'E')
+                    << "\",\"ts\":" << timestamp
+                    << ",\"pid\":" << pid
+                    << ",\"tid\":" << ring->threadId << '}';
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    std::string ChromeTrace()
+    {
+        std::ostringstream res;
+        WriteChromeTrace(res);
+        return res.str();
+    }
+
+    bool DumpChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+        WriteChromeTrace(file);
+        return (bool)file.flush();
+    }
+
+    TraceSpan::TraceSpan(const char* name) noexcept
+        : name(Internal::tracingEnabled.load(std::memory_order_relaxed) ? name : nullptr)
+    {
+        if (this->name != nullptr)
+            Internal::Record(this->name, Internal::TracePhase::Begin, Internal::TraceCategory::Native);
+    }
+
+    TraceSpan::~TraceSpan()
+    {
+        // a span begun while tracing was enabled is always closed
+        if (name != nullptr)
+            Internal::Record(name, Internal::TracePhase::End, Internal::TraceCategory::Native);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace AngouriMath
+{
+    struct TracingOptions
+    {
+        // spans beyond this many per thread overwrite the oldest ones
+        size_t eventsPerThread = 1u << 16;
+        // also record the spans of the managed exports, one per call
+        bool managed = true;
+    };
+
+    // Opt-in recording of nested spans on both sides of the native boundary: the
+    // C++ wrapper methods, the managed exports and, inside them, object storage
+    // lookups and string marshalling. Every thread records into its own lock-free
+    // ring, so tracing does not serialize the traced threads. Disabled, a span
+    // costs one relaxed atomic load.
+    void EnableTracing(const TracingOptions& options = {});
+    void DisableTracing();
+    bool IsTracingEnabled();
+    // Drops the spans recorded so far
+    void ClearTrace();
+
+    // Recorded spans in the Chrome trace event format, which chrome://tracing
+    // and Perfetto load. Spans whose begin was overwritten are skipped.
+    void WriteChromeTrace(std::ostream& out);
+    std::string ChromeTrace();
+    // Returns false if the file cannot be written
+    bool DumpChromeTrace(const std::string& path);
+
+    // Records a span from construction to destruction on the calling thread;
+    // name must outlive the trace, e. g. be a string literal
+    class TraceSpan
+    {
+    public:
+        explicit TraceSpan(const char* name) noexcept;
+        ~TraceSpan();
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        const char* name;
+    };
+}
@@ -6,10 +6,15 @@ namespace AngouriMath::Internal
 {
     typedef uint64_t EntityRef;
     typedef EntityRef* EntityOut;
+    // managed enumerator of entities
+    typedef uint64_t CursorRef;
     typedef char** StringOut;
 
     typedef const char* String;
     typedef int32_t ApproachFrom; // in the outer API, it should be a enum
+    typedef int32_t NativeBool;
+    // name is owned by the managed side and lives until the process exits, phase is 0 for begin, 1 for end
+    typedef void (*TraceSink)(const char* name, int32_t phase);
 
     typedef struct { int64_t first; int64_t second; } LongTuple;
     typedef struct { double first; double second; } DoubleTuple;
@@ -26,4 +31,97 @@ namespace AngouriMath::Internal
         int32_t length;
         const EntityRef* refs;
     };
-}
\ No newline at end of file
+
+    struct NativeBuffer
+    {
+        int32_t length;
+        const void* data;
+    };
+
+    struct NativeInstruction
+    {
+        int32_t opCode;
+        int32_t first;
+        int32_t second;
+        double real;
+        double imaginary;
+    };
+
+    struct NativeRoot
+    {
+        double real;
+        double imaginary;
+        int32_t kind;
+    };
+
+    struct NativePolynomialTerm
+    {
+        int64_t power;
+        double real;
+        double imaginary;
+        int64_t numerator;
+        int64_t denominator;
+        NativeBool isRational;
+    };
+
+    struct NativeSimplifyReport
+    {
+        int32_t alternativesExplored;
+        NativeBool budgetExceeded;
+    };
+
+    // One step of the postfix program built by the native parser, start and length
+    // are the text of numbers, variables and function names in the source
+    struct NativeParseNode
+    {
+        int32_t kind;
+        int32_t start;
+        int32_t length;
+        int32_t arity;
+    };
+
+    struct NativeIncrementalReport
+    {
+        int32_t simplified;
+        int32_t reused;
+    };
+
+    struct NativeGcInfo
+    {
+        NativeBool isServer;
+        NativeBool isConcurrent;
+        int32_t latencyMode;
+        int32_t conserveMemory;
+        int64_t heapHardLimitBytes;
+        int64_t heapSizeBytes;
+        int64_t committedBytes;
+        int64_t fragmentedBytes;
+        int64_t totalAllocatedBytes;
+        int64_t gen0Collections;
+        int64_t gen1Collections;
+        int64_t gen2Collections;
+        int64_t totalPauseNanoseconds;
+        int64_t lastPauseNanoseconds;
+        double pauseTimePercentage;
+    };
+
+    struct NativeSettings
+    {
+        int32_t mask;
+        int32_t floatToRationalIterCount;
+        int64_t maxAbsNumeratorOrDenominatorValue;
+        double precisionErrorCommon;
+        double precisionErrorZeroRange;
+        NativeBool allowNewton;
+        NativeBool downcastingEnabled;
+        NativeBool explicitParsingOnly;
+        int32_t newtonPrecision;
+        int64_t maxExpansionTermCount;
+        double newtonFromRe;
+        double newtonFromIm;
+        double newtonToRe;
+        double newtonToIm;
+        int32_t newtonStepsRe;
+        int32_t newtonStepsIm;
+    };
+}